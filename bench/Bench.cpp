@@ -0,0 +1,290 @@
+#include <cinttypes>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+#include "Elevator.hpp"
+#include "Controller.hpp"
+#include "Parsing.hpp"
+
+// Короткая запись типов времени.
+typedef std::chrono::steady_clock bench_clock;
+
+////////////////   Messaging   /////////////////
+// Замеры пропускной способности и задержки передачи сообщений.
+struct MessagingResult
+{
+    double throughput;      // Сообщений в секунду при потоковой передаче.
+    double round_trip_mean; // Средняя задержка туда-обратно, нс.
+    double round_trip_p50;  // Медиана задержки туда-обратно, нс.
+    double round_trip_p99;  // 99-й перцентиль задержки туда-обратно, нс.
+};
+
+template<typename Channel>
+double measure_throughput(size_t messages_number)
+{
+    Channel channel;
+    Elevator::Incoming incoming = {};
+
+    auto begin = bench_clock::now();
+    std::thread producer([&channel, incoming, messages_number]() mutable
+    {
+        for (size_t message = 0; message < messages_number; ++message)
+        {
+            incoming.id = static_cast<mid_t>(message);
+            channel.send(incoming);
+        }
+    });
+    for (size_t message = 0; message < messages_number; ++message)
+    { channel.receive(); }
+    producer.join();
+
+    double seconds = std::chrono::duration<double>(bench_clock::now() - begin).count();
+    return messages_number / seconds;
+}
+
+template<typename Channel>
+MessagingResult measure_messaging(size_t messages_number, size_t round_trips_number)
+{
+    MessagingResult result;
+    result.throughput = measure_throughput<Channel>(messages_number);
+
+    // Задержка: сообщение передаётся второму потоку, который сразу отвечает.
+    Channel ping;
+    Channel pong;
+    std::thread echo([&ping, &pong, round_trips_number]()
+    {
+        for (size_t trip = 0; trip < round_trips_number; ++trip)
+        { pong.send(ping.receive()); }
+    });
+
+    std::vector<double> samples(round_trips_number);
+    Elevator::Incoming incoming = {};
+    for (size_t trip = 0; trip < round_trips_number; ++trip)
+    {
+        auto begin = bench_clock::now();
+        ping.send(incoming);
+        pong.receive();
+        samples[trip] = std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count();
+    }
+    echo.join();
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (size_t trip = 0; trip < samples.size(); ++trip) { sum += samples[trip]; }
+    result.round_trip_mean = sum / samples.size();
+    result.round_trip_p50 = samples[samples.size() / 2];
+    result.round_trip_p99 = samples[samples.size() * 99 / 100];
+    return result;
+}
+
+void print_messaging(std::ostream& output, const std::string& name, const MessagingResult& result)
+{
+    output << "{\"implementation\": \"" << name << "\", "
+           << "\"throughput_messages_per_second\": " << result.throughput << ", "
+           << "\"round_trip_ns_mean\": " << result.round_trip_mean << ", "
+           << "\"round_trip_ns_p50\": " << result.round_trip_p50 << ", "
+           << "\"round_trip_ns_p99\": " << result.round_trip_p99 << "}";
+}
+
+////////////////     Ticks     /////////////////
+// Замеры скорости моделирования на сетке (этажи x лифты x нагрузка).
+class BenchController : public Controller
+{
+public:
+    using Controller::Controller;
+
+    tick_t ticks() const { return timestamp; }
+    uint64_t steps() const { return steps_count; }
+    double seconds() const { return std::chrono::duration<double>(wall_time).count(); }
+};
+
+// Трасса прибытий: load человек на лифт за каждые 100 тиков на протяжении span тиков.
+std::string generate_trace(size_t floors_number, size_t elevators_number, size_t load, tick_t span, uint32_t seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<ssize_t> floors(0, floors_number - 1);
+    std::uniform_int_distribution<tick_t> times(0, span);
+
+    size_t persons_number = span / 100 * elevators_number * load;
+    std::vector<tick_t> timestamps(persons_number);
+    for (size_t person = 0; person < persons_number; ++person) { timestamps[person] = times(generator); }
+    std::sort(timestamps.begin(), timestamps.end());
+
+    std::ostringstream trace;
+    for (size_t person = 0; person < persons_number; ++person)
+    {
+        ssize_t origin = floors(generator);
+        ssize_t destination = floors(generator);
+        if (destination == origin) { destination = (origin + 1) % floors_number; }
+        trace << timestamps[person] << " " << origin << " " << destination << "\n";
+    }
+    return trace.str();
+}
+
+void print_ticks(std::ostream& output, size_t floors_number, size_t elevators_number, size_t load, bool event_driven, tick_t span)
+{
+    Elevator::Settings settings = {8, 3, 2, 2, 4, 1, 1};
+    Controller::Options options;
+    options.interactive = false;
+    options.event_driven = event_driven;
+
+    std::istringstream input(generate_trace(floors_number, elevators_number, load, span, 1));
+    BenchController controller(floors_number, elevators_number, settings, options);
+    controller.run(input);
+
+    output << "{\"floors\": " << floors_number << ", "
+           << "\"elevators\": " << elevators_number << ", "
+           << "\"load\": " << load << ", "
+           << "\"event_driven\": " << (event_driven ? "true" : "false") << ", "
+           << "\"ticks\": " << controller.ticks() << ", "
+           << "\"steps\": " << controller.steps() << ", "
+           << "\"wall_seconds\": " << controller.seconds() << ", "
+           << "\"ticks_per_second\": " << (controller.seconds() > 0.0 ? controller.ticks() / controller.seconds() : 0.0) << "}";
+}
+
+////////////////   Decisions   /////////////////
+// Замеры стоимости выбора следующей цели лифтом при разной плотности вызовов.
+class BenchElevator : public Elevator
+{
+public:
+    BenchElevator(const Settings& init_settings, size_t floors_number) : Elevator(init_settings, floors_number) { }
+
+    void call(ssize_t call_floor, Direction call_direction) { insert_call(call_floor, call_direction); }
+
+    bool closest(ssize_t from) // Выбор ближайшего вызова из режима ожидания.
+    {
+        reset(from, Direction::None);
+        bool result = _switch_closest();
+        outgoing.clear();
+        return result;
+    }
+    bool not_selected(ssize_t from, Direction moving) // Выбор вызова при движении в заданном направлении.
+    {
+        reset(from, moving);
+        bool result = _switch_not_selected();
+        outgoing.clear();
+        return result;
+    }
+    ssize_t target() const { return destination; }
+
+protected:
+    void reset(ssize_t from, Direction moving)
+    {
+        state = State::Waiting;
+        floor = from;
+        direction = moving;
+        is_destination_selected = false;
+        is_ignoring_other = false;
+    }
+};
+
+void print_decisions(std::ostream& output, size_t floors_number, double density, size_t iterations)
+{
+    Elevator::Settings settings = {8, 3, 2, 2, 4, 1, 1};
+    BenchElevator elevator(settings, floors_number);
+
+    // Вызовы занимают долю density этажей в каждой из трёх групп.
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (ssize_t floor = 0; floor < static_cast<ssize_t>(floors_number); ++floor)
+    {
+        for (Elevator::Direction direction : { Elevator::Direction::None, Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+        {
+            if (uniform(generator) < density) { elevator.call(floor, direction); }
+        }
+    }
+
+    std::vector<ssize_t> origins(1024);
+    std::uniform_int_distribution<ssize_t> floors(0, floors_number - 1);
+    for (size_t index = 0; index < origins.size(); ++index) { origins[index] = floors(generator); }
+
+    // Результаты суммируются, чтобы вызовы не были выброшены оптимизатором.
+    ssize_t sink = 0;
+    auto measure = [&](auto decide)
+    {
+        auto begin = bench_clock::now();
+        for (size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            decide(origins[iteration & (origins.size() - 1)]);
+            sink += elevator.target();
+        }
+        return std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count() / iterations;
+    };
+    double closest = measure([&](ssize_t from) { elevator.closest(from); });
+    double upwards = measure([&](ssize_t from) { elevator.not_selected(from, Elevator::Direction::Upwards); });
+    double downwards = measure([&](ssize_t from) { elevator.not_selected(from, Elevator::Direction::Downwards); });
+
+    output << "{\"floors\": " << floors_number << ", "
+           << "\"density\": " << density << ", "
+           << "\"switch_closest_ns\": " << closest << ", "
+           << "\"switch_not_selected_up_ns\": " << upwards << ", "
+           << "\"switch_not_selected_down_ns\": " << downwards << ", "
+           << "\"checksum\": " << sink << "}";
+}
+
+int main(int argc, char** argv)
+{
+    size_t messages_number = 1000000;
+    size_t round_trips_number = 20000;
+    bool is_valid = (argc <= 1) || parse_number(argv[1], messages_number);
+    is_valid = is_valid && ((argc <= 2) || parse_number(argv[2], round_trips_number));
+    tick_t span = 2000;
+    size_t iterations = 1000000;
+    is_valid = is_valid && ((argc <= 3) || parse_number(argv[3], span));
+    is_valid = is_valid && ((argc <= 4) || parse_number(argv[4], iterations));
+    if (!is_valid)
+    {
+        std::cerr << "Использование: " << argv[0] << " [сообщения] [замеры_задержки] [длительность_трассы] [итерации_решений]" << std::endl;
+        return 1;
+    }
+
+    // Сравнение реализаций передачи сообщений независимо от выбранной при сборке.
+    MessagingResult queue = measure_messaging<QueueMessaging<Elevator::Incoming>>(messages_number, round_trips_number);
+    MessagingResult ring = measure_messaging<RingMessaging<Elevator::Incoming>>(messages_number, round_trips_number);
+
+    std::cout << "{\"messaging\": [";
+    print_messaging(std::cout, "queue", queue);
+    std::cout << ", ";
+    print_messaging(std::cout, "ring", ring);
+    std::cout << "]," << std::endl;
+
+    // Скорость моделирования (используется транспорт, выбранный при сборке).
+    std::cout << "\"ticks\": [";
+    bool is_first = true;
+    for (size_t floors_number : { 10, 40, 160 })
+    {
+        for (size_t elevators_number : { 4, 16, 64 })
+        {
+            for (size_t load : { 1, 5 })
+            {
+                for (bool event_driven : { false, true })
+                {
+                    std::cout << (is_first ? "" : ",") << std::endl << "  ";
+                    print_ticks(std::cout, floors_number, elevators_number, load, event_driven, span);
+                    is_first = false;
+                }
+            }
+        }
+    }
+    std::cout << "]," << std::endl;
+
+    // Стоимость принятия решений лифтом.
+    std::cout << "\"decisions\": [";
+    is_first = true;
+    for (size_t floors_number : { 16, 256, 4096 })
+    {
+        for (double density : { 0.01, 0.1, 0.5 })
+        {
+            std::cout << (is_first ? "" : ",") << std::endl << "  ";
+            print_decisions(std::cout, floors_number, density, iterations);
+            is_first = false;
+        }
+    }
+    std::cout << "]}" << std::endl;
+    return 0;
+}
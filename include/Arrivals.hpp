@@ -0,0 +1,55 @@
+#ifndef ARRIVALS
+#define ARRIVALS
+
+#include <iostream>
+#include <vector>
+
+#include "Elevator.hpp"
+
+////////////////    Arrivals    ////////////////
+// Источник прибытий людей в порядке неубывания времени.
+class Arrivals
+{
+public:
+    virtual ~Arrivals() { }
+
+    virtual bool next(Person& person) = 0; // Следующий человек (false, если прибытия закончились).
+};
+
+//////////////// TraceArrivals /////////////////
+// Прибытия из текстовой трассы: строки "время этаж_прибытия этаж_назначения".
+class TraceArrivals : public Arrivals
+{
+public:
+    TraceArrivals(std::istream& init_input);
+
+    bool next(Person& person) override;
+
+protected:
+    std::istream& input;
+
+private:
+
+};
+
+//////////////// ReplayArrivals /////////////////
+// Прибытия из заранее разобранной трассы в памяти. Трасса только читается,
+// поэтому одну трассу могут одновременно воспроизводить несколько прогонов.
+class ReplayArrivals : public Arrivals
+{
+public:
+    ReplayArrivals(const std::vector<Person>& init_persons);
+
+    static void load(Arrivals& source, std::vector<Person>& persons); // Чтение всех прибытий источника в память.
+
+    bool next(Person& person) override;
+
+protected:
+    const std::vector<Person>& persons;
+    size_t position = 0;
+
+private:
+
+};
+
+#endif
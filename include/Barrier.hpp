@@ -0,0 +1,41 @@
+#ifndef BARRIER
+#define BARRIER
+
+#include <cstddef>
+#include <mutex>
+#include <condition_variable>
+
+////////////////    Barrier    /////////////////
+// Многоразовый барьер для постоянного числа потоков: wait() возвращается, когда его вызвали все участники
+// текущей фазы. Записи, сделанные участниками до барьера, видны всем участникам после него.
+class Barrier
+{
+public:
+    Barrier(size_t init_participants) : participants(init_participants) { }
+
+    void wait() // Дождаться остальных участников.
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t phase = generation;
+        if (++arrived == participants)
+        {
+            arrived = 0;
+            ++generation;
+            condition.notify_all();
+            return;
+        }
+        condition.wait(lock, [this, phase]() { return generation != phase; });
+    }
+
+protected:
+    const size_t participants;
+    size_t arrived = 0;    // Число участников, дошедших до барьера в текущей фазе.
+    size_t generation = 0; // Номер фазы.
+    std::mutex mutex;
+    std::condition_variable condition;
+
+private:
+
+};
+
+#endif
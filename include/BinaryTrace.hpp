@@ -0,0 +1,83 @@
+#ifndef BINARY_TRACE
+#define BINARY_TRACE
+
+#include <cinttypes>
+#include <iostream>
+#include <string>
+
+#include "Arrivals.hpp"
+
+////////////////  BinaryTrace  /////////////////
+// Двоичный формат трассы прибытий: заголовок с параметрами модели, записи фиксированной длины
+// в порядке неубывания времени и индекс по времени (время каждой index_stride-й записи).
+// Числа хранятся в порядке байтов машины, на которой создан файл.
+class BinaryTrace
+{
+public:
+    static constexpr char magic[8] = {'E', 'L', 'V', 'T', 'R', 'A', 'C', 'E'};
+    static constexpr uint32_t version = 1;
+    static constexpr uint64_t index_stride = 4096; // Число записей между соседними элементами индекса.
+    static constexpr uint64_t timestamp_mask = (uint64_t(1) << 48) - 1;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t floors_number;
+        uint64_t elevators_number;
+        uint64_t settings[7];     // Параметры лифтов в порядке текстового формата: вместимость, подъём, открытие, ожидание, закрытие, вход, выход.
+        uint64_t records_number;
+        uint64_t index_offset;    // Смещение индекса от начала файла.
+        uint64_t index_entries;
+        uint64_t reserved[3];
+    };
+
+    struct Record
+    {
+        uint64_t stamp;      // Время прибытия (младшие 48 бит) и метки (старшие 16 бит).
+        int32_t origin;      // Этаж прибытия.
+        int32_t destination; // Этаж-пункт назначения.
+    };
+
+    // Преобразование текстовой трассы (строка параметров модели, затем строки "время прибытие назначение [метки]").
+    static bool convert(std::istream& input, const std::string& path, std::ostream& errors = std::cerr);
+    static bool probe(const std::string& path); // Является ли файл двоичной трассой.
+
+private:
+
+};
+
+//////////////// BinaryArrivals /////////////////
+// Прибытия из двоичной трассы, отображённой в память: записи читаются прямо из отображения без копирования.
+class BinaryArrivals : public Arrivals
+{
+public:
+    BinaryArrivals();
+    ~BinaryArrivals();
+
+    bool open(const std::string& path, std::ostream& errors = std::cerr); // Отображение файла в память и проверка заголовка.
+    void close();
+
+    const BinaryTrace::Header& header() const { return *_header; }
+    Elevator::Settings settings() const; // Параметры лифтов из заголовка.
+    uint64_t size() const { return _header ? _header->records_number : 0; } // Число записей.
+    void seek(tick_t timestamp); // Переход к первой записи не раньше заданного времени (по индексу).
+
+    bool next(Person& person) override;
+    uint16_t tags() const { return last_tags; } // Метки последней выданной записи.
+
+protected:
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    const BinaryTrace::Header* _header = nullptr;
+    const BinaryTrace::Record* records = nullptr;
+    const uint64_t* index = nullptr;
+    uint64_t position = 0;
+    uint16_t last_tags = 0;
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef CALL_REGISTRY
+#define CALL_REGISTRY
+
+#include <cinttypes>
+#include <cstddef>
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "Checkpoint.hpp"
+
+//////////////// CallRegistry /////////////////
+// Реестр вызовов: для каждой группы (направления) - битовое множество этажей.
+// Добавление и удаление вызова - смена одного бита, поиск ближайших вызовов - поиск первого/последнего
+// установленного бита в машинных словах (count trailing/leading zeros).
+class CallRegistry
+{
+public:
+    static constexpr size_t groups = 3;  // Число групп вызовов.
+    static constexpr ssize_t none = -1;  // Результат поиска при отсутствии вызовов.
+
+    CallRegistry(size_t floors_number = 0)
+    {
+        reserve(floors_number);
+    }
+
+    void reserve(size_t floors_number) // Выделение памяти под заданное число этажей.
+    {
+        size_t words_number = (floors_number + 63) / 64;
+        if (words_number <= words[0].size()) { return; }
+        for (size_t group = 0; group < groups; ++group)
+        { words[group].resize(words_number, 0); }
+    }
+
+    void insert(size_t group, ssize_t floor) // Добавить вызов.
+    {
+        if (floor < 0) { return; }
+        reserve(static_cast<size_t>(floor) + 1);
+        uint64_t& word = words[group][static_cast<size_t>(floor) >> 6];
+        uint64_t bit = uint64_t(1) << (floor & 63);
+        counts[group] += (word & bit) ? 0 : 1;
+        word |= bit;
+    }
+    void erase(size_t group, ssize_t floor) // Отменить вызов.
+    {
+        if ((floor < 0) || (static_cast<size_t>(floor) >= words[group].size() * 64)) { return; }
+        uint64_t& word = words[group][static_cast<size_t>(floor) >> 6];
+        uint64_t bit = uint64_t(1) << (floor & 63);
+        counts[group] -= (word & bit) ? 1 : 0;
+        word &= ~bit;
+    }
+    bool contains(size_t group, ssize_t floor) const // Есть ли вызов с этажа.
+    {
+        if ((floor < 0) || (static_cast<size_t>(floor) >= words[group].size() * 64)) { return false; }
+        return (words[group][static_cast<size_t>(floor) >> 6] >> (floor & 63)) & 1;
+    }
+
+    bool empty(size_t group) const { return counts[group] == 0; } // Нет вызовов в группе.
+    bool empty() const // Нет вызовов вообще.
+    {
+        for (size_t group = 0; group < groups; ++group)
+        {
+            if (counts[group] != 0) { return false; }
+        }
+        return true;
+    }
+    size_t size(size_t group) const { return counts[group]; } // Число вызовов в группе.
+
+    ssize_t at_or_above(size_t group, ssize_t floor) const // Ближайший вызов с этажа не ниже заданного.
+    {
+        const std::vector<uint64_t>& bits = words[group];
+        size_t index = (floor < 0) ? 0 : static_cast<size_t>(floor);
+        size_t word = index >> 6;
+        if (word >= bits.size()) { return none; }
+
+        uint64_t value = bits[word] & (~uint64_t(0) << (index & 63));
+        while (value == 0)
+        {
+            if (++word == bits.size()) { return none; }
+            value = bits[word];
+        }
+        return static_cast<ssize_t>((word << 6) + __builtin_ctzll(value));
+    }
+    ssize_t below(size_t group, ssize_t floor) const // Ближайший вызов с этажа строго ниже заданного.
+    {
+        const std::vector<uint64_t>& bits = words[group];
+        if ((floor <= 0) || bits.empty()) { return none; }
+        size_t index = std::min(static_cast<size_t>(floor), bits.size() * 64) - 1;
+        size_t word = index >> 6;
+
+        uint64_t value = bits[word] & (~uint64_t(0) >> (63 - (index & 63)));
+        while (value == 0)
+        {
+            if (word == 0) { return none; }
+            value = bits[--word];
+        }
+        return static_cast<ssize_t>((word << 6) + 63 - __builtin_clzll(value));
+    }
+    ssize_t nearest(size_t group, ssize_t floor) const // Ближайший вызов в любую сторону (при равенстве - нижний).
+    {
+        ssize_t above = at_or_above(group, floor);
+        ssize_t under = below(group, floor);
+        if (above == none) { return under; }
+        if (under == none) { return above; }
+        return (above - floor < floor - under) ? above : under;
+    }
+
+    void store(Checkpoint& checkpoint) const // Запись в контрольную точку.
+    {
+        for (size_t group = 0; group < groups; ++group) { checkpoint.write(words[group]); }
+        checkpoint.write(counts);
+    }
+    bool restore(Checkpoint::Reader& reader) // Чтение из контрольной точки.
+    {
+        for (size_t group = 0; group < groups; ++group)
+        {
+            if (!reader.read(words[group])) { return false; }
+        }
+        // Во всех группах должно быть одинаковое число слов.
+        if ((words[1].size() != words[0].size()) || (words[2].size() != words[0].size())) { return reader.fail(); }
+        return reader.read(counts);
+    }
+
+protected:
+    std::array<std::vector<uint64_t>, groups> words; // Битовые множества этажей.
+    std::array<size_t, groups> counts = {};          // Число вызовов в каждой группе.
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <cinttypes>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+////////////////   Checkpoint   ////////////////
+// Контрольная точка модели: последовательность полей в двоичном виде (в порядке байтов машины, на которой она создана).
+// Каждая часть модели дописывает своё состояние методом store() и читает его в том же порядке методом restore().
+// Одна загруженная контрольная точка может одновременно читаться несколькими читателями (для ветвления прогонов).
+class Checkpoint
+{
+public:
+    static constexpr char magic[8] = {'E', 'L', 'V', 'C', 'H', 'K', 'P', 'T'};
+    static constexpr uint32_t version = 5;
+
+    template<typename T>
+    void write(const T& value) // Дописать значение простого типа.
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Поле контрольной точки должно копироваться побайтово.");
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template<typename T>
+    void write(const std::vector<T>& values) // Дописать массив значений простого типа (с длиной).
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Поле контрольной точки должно копироваться побайтово.");
+        write<uint64_t>(values.size());
+        data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    bool save(const std::string& path, std::ostream& errors = std::cerr) const; // Запись в файл.
+    bool load(const std::string& path, std::ostream& errors = std::cerr); // Чтение из файла.
+    size_t size() const { return data.size(); }
+
+    //////////////// Checkpoint::Reader ////////////////
+    // Последовательное чтение полей. После первой ошибки (нехватки данных) все чтения неуспешны.
+    class Reader
+    {
+    public:
+        Reader(const Checkpoint& init_checkpoint) : checkpoint(init_checkpoint) { }
+
+        template<typename T>
+        bool read(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Поле контрольной точки должно копироваться побайтово.");
+            if (!take(sizeof(T))) { return false; }
+            std::memcpy(&value, checkpoint.data.data() + position - sizeof(T), sizeof(T));
+            return true;
+        }
+        template<typename T>
+        bool read(std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Поле контрольной точки должно копироваться побайтово.");
+            uint64_t size = 0;
+            if (!read(size) || (size > (checkpoint.data.size() - position) / sizeof(T))) { return fail(); }
+            values.resize(size);
+            if (!take(size * sizeof(T))) { return false; }
+            if (size) { std::memcpy(values.data(), checkpoint.data.data() + position - size * sizeof(T), size * sizeof(T)); }
+            return true;
+        }
+
+        bool good() const { return !is_failed; } // Все ли чтения были успешны.
+        bool fail() { is_failed = true; return false; } // Пометить данные некорректными.
+        bool finished() const { return position == checkpoint.data.size(); } // Прочитаны ли все данные.
+
+    protected:
+        const Checkpoint& checkpoint;
+        size_t position = 0;
+        bool is_failed = false;
+
+        bool take(size_t bytes) // Сдвинуть позицию чтения, если данных достаточно.
+        {
+            if (is_failed || (bytes > checkpoint.data.size() - position)) { return fail(); }
+            position += bytes;
+            return true;
+        }
+
+    private:
+
+    };
+
+protected:
+    std::string data; // Поля без заголовка файла.
+
+private:
+
+};
+
+#endif
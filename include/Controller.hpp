@@ -1,40 +1,156 @@
 #ifndef CONTROLLER
 #define CONTROLLER
 
-#include <list>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <thread>
 #include <iostream>
+#include <chrono>
 #include "Elevator.hpp"
+#include "Executor.hpp"
+#include "ElevatorFleet.hpp"
+#include "Dispatcher.hpp"
+#include "PassengerQueues.hpp"
+#include "Renderer.hpp"
+#include "Metrics.hpp"
+#include "Arrivals.hpp"
+#include "Checkpoint.hpp"
 
 ////////////////   Controller   ////////////////
 // Класс для управления лифтами.
 class Controller
 {
 public:
-    Controller(const size_t floors_number, const size_t elevators_number, const Elevator::Settings& default_settings);
+    struct Options
+    {
+        bool interactive = true;   // Интерактивный режим (отрисовка, приглашения ввода и задержка между тиками).
+        bool event_driven = false; // Переход сразу к ближайшему событию вместо рассылки единичных тиков.
+        bool pooled = false;       // Выполнение лифтов в пуле потоков вместо отдельного потока на каждый лифт.
+        size_t workers = 0;        // Размер пула потоков (0 - по числу ядер).
+        bool dispatched = false;   // Назначение вызовов с этажей одному лифту диспетчером вместо рассылки всем лифтам.
+        bool destination = false;  // Назначение людей лифтам группами по секторам этажей назначения (вместо вызовов по направлению).
+        size_t sectors = 0;        // Число секторов этажей назначения (0 - по вместимости лифтов).
+        bool bulk = false;         // Обмен пассажирами одним сообщением за остановку вместо посадки и высадки по одному человеку.
+        size_t frame_rate = 30;    // Предельная частота кадров отрисовки в интерактивном режиме.
+        tick_t report_interval = 0; // Интервал промежуточного вывода показателей в пакетном режиме (0 - только в сводке).
+        tick_t window = 100;       // Окно подсчёта пропускной способности.
+        std::chrono::milliseconds delay = std::chrono::milliseconds(100); // Задержка между тиками в интерактивном режиме.
+        std::ostream* output = &std::cout; // Поток для отрисовки и промежуточного вывода показателей.
+        tick_t pause_at = Elevator::never; // Момент остановки пакетного прогона (например, для записи контрольной точки).
+        std::function<void(const Person&)> alighted; // Обработчик выхода пассажира из лифта (например, для пересадки в другую зону).
+    };
+
+    Controller(const size_t floors_number, const size_t elevators_number, const Elevator::Settings& default_settings, const Options& init_options);
+    // Разнородные лифты: свои параметры и набор обслуживаемых этажей у каждого лифта.
+    Controller(const size_t floors_number, const std::vector<Elevator::Settings>& init_settings, const std::vector<FloorMask>& masks, const Options& init_options);
     ~Controller();
 
-    void loop();
+    void loop(std::istream& input = std::cin); // Интерактивный цикл работы.
+    // Пакетный прогон до полной развозки людей или до момента pause_at (тогда возвращается false).
+    // Прибытия, учтённые до восстановленной контрольной точки, пропускаются.
+    bool run(std::istream& input); // По текстовой трассе прибытий.
+    bool run(Arrivals& arrivals); // По источнику прибытий.
+
+    // Контрольная точка: полное состояние контроллера и всех лифтов. Записывается между тиками (после остановки прогона).
+    // Восстанавливается в только что созданный контроллер с теми же числами этажей и лифтов; параметры лифтов и настройки
+    // контроллера берутся из конструктора, поэтому из одной контрольной точки можно ответвить несколько прогонов.
+    void checkpoint(Checkpoint& checkpoint) const;
+    bool restore(const Checkpoint& checkpoint);
+    static bool describe(const Checkpoint& checkpoint, size_t& floors_number, size_t& elevators_number); // Параметры модели контрольной точки.
+
+    // Пошаговое выполнение внешним циклом (например, зоной многозонной модели).
+    bool advance(tick_t until); // Обработка тиков вплоть до заданного момента времени (false - прогон остановлен в момент pause_at).
+    void settle(tick_t until); // Досчёт модели до развозки всех людей, но не дальше заданного момента времени.
+    void enqueue(const Person& person); // Постановка человека в очередь и вызов лифта.
+    bool is_finished(); // Все ли люди доставлены.
+
+    void print_summary(std::ostream& output); // Вывод машиночитаемой сводки по прогону.
+
+    // Итоги прогона.
+    tick_t get_timestamp() const { return timestamp; }
+    uint64_t get_delivered() const { return delivered_count; }
+    double get_wall_seconds() const { return std::chrono::duration<double>(wall_time).count(); }
+    const Metrics& get_metrics() const { return metrics; }
 
 protected:
+    // Настройки.
+    Options options;
+    std::vector<Elevator::Settings> elevators_settings; // Параметры каждого лифта.
+    std::vector<FloorMask> served; // Обслуживаемые каждым лифтом этажи.
+    bool is_restricted = false;    // Есть лифты, обслуживающие не все этажи.
+
     // Коммуникация с лифтами.
     mid_t id_counter = 0;
     tick_t timestamp = 0;
 
+    // Статистика прогона.
+    uint64_t steps_count = 0;     // Число разосланных тиков.
+    uint64_t arrived_count = 0;   // Число поступивших людей.
+    uint64_t rejected_count = 0;  // Число отброшенных людей (некорректные этажи).
+    uint64_t delivered_count = 0; // Число доставленных людей.
+    uint64_t posted_count = 0;    // Число сообщений, поставленных в очереди лифтов.
+    uint64_t reassigned_count = 0; // Число переназначенных диспетчером вызовов.
+    std::chrono::steady_clock::duration wall_time = std::chrono::steady_clock::duration::zero(); // Время работы пакетного прогона.
+    Metrics metrics; // Показатели обслуживания людей и загрузки лифтов.
+    tick_t next_report = 0; // Время следующего промежуточного вывода показателей.
+
     // Структуры, связанные с лифтами.
-    std::vector<Elevator> elevators;
+    std::deque<Elevator> elevators; // Лифты не копируются и не перемещаются (на них ссылаются их потоки).
     std::vector<std::thread> elevators_threads;
+    ElevatorFleet fleet; // Последнее известное состояние лифтов (структура массивов).
+    std::vector<size_t> elevators_due; // Лифты, получившие тик на текущем шаге.
+    Countdown tick_countdown; // Барьер завершения тика лифтами (кроме встроенного транспорта).
+    std::unique_ptr<Executor> executor; // Пул потоков (в режиме pooled вместо elevators_threads).
+    Dispatcher dispatcher; // Распределение вызовов с этажей (в режиме dispatched) и группы лифтов по обслуживаемым этажам.
+    std::vector<char> groups_called; // Группы лифтов, которым требуется вызов (при ограниченных наборах этажей).
 
     // Структуры, связанные с людьми.
-    std::vector<std::list<std::pair<Elevator::Direction, Person>>> floor_persons; // Массив с людьми для каждого этажа.
+    PassengerQueues floor_queues; // Очереди людей вверх и вниз для каждого этажа.
+    std::vector<std::vector<Person>> manifests; // Зеркала состава пассажиров лифтов (по событиям Boarded, Alighted и Exchanged).
+    std::vector<uint64_t> manifests_versions;   // Номера версий зеркал (увеличиваются при каждом изменении).
+    std::vector<std::vector<Person>> offers;    // Буферы людей, предлагаемых каждому лифту при обмене пассажирами (по вместимости).
+    std::vector<std::pair<uint32_t, uint32_t>> offered_records; // Их записи в очереди этажа и предшествующие им записи.
 
     // Структуры, связанные с отрисовкой модели.
     std::vector<std::string> elevators_strings; // Строки, отображающие текущий набор людей в лифте.
-    std::vector<size_t> elevators_floors; // Номера текущих этажей лифтов.
+    std::vector<uint64_t> elevators_strings_versions; // Версии зеркал, по которым построены строки.
+    std::unique_ptr<Renderer> renderer; // Поток отрисовки (в интерактивном режиме).
+    Renderer::Frame frame; // Буфер для построения кадра.
+
+    tick_t next_delta(tick_t until); // Шаг времени до ближайшего события (не дальше until).
+    void tick(tick_t delta = 1); // Обработка интервала времени.
+    static bool read_header(Checkpoint::Reader& reader, size_t& floors_number, std::vector<Elevator::Settings>& settings); // Чтение параметров модели.
+
+    // Вызовы с этажей: рассылка всем лифтам или, в режиме dispatched, назначение одному лифту.
+    // При ограниченных наборах этажей вызов получают только лифты, обслуживающие этаж вызова и пункт назначения
+    // (destination, а если он не указан - пункт назначения хотя бы одного ожидающего в очереди).
+    void hall_call(ssize_t floor, Elevator::Direction direction, ssize_t destination = -1); // Вызов лифта на этаж.
+    void hall_cancel(size_t elevator, ssize_t floor, Elevator::Direction direction); // Отмена вызова по прибытии лифта.
+    void rebalance(size_t elevator); // Переназначение вызовов задержавшегося лифта.
+    // Назначение по пунктам назначения (в режиме destination).
+    void destination_call(ssize_t floor, Elevator::Direction direction, uint32_t record); // Назначение человека из очереди лифту.
+    void depart(size_t elevator, ssize_t floor); // Переназначение не вошедших в отбывший лифт людей.
+    bool boards(size_t elevator, uint32_t record) const; // Должен ли лифт забрать человека из очереди.
+
+    // Сообщения копятся в очередях и отправляются лифтам пачками.
+    // Транспорт выбирается при сборке: TRANSPORT_INLINE - синхронный вызов Elevator::step() в потоке контроллера,
+    // иначе - почтовые ящики Messaging и потоки (или пул потоков) лифтов.
+    std::vector<std::vector<Elevator::Incoming>> elevators_pending; // Неотправленные сообщения для каждого лифта.
+    #ifdef TRANSPORT_INLINE
+    std::vector<std::deque<Elevator::Outcoming>> elevators_outbox; // Ответы лифтов при встроенном транспорте.
+    #endif
 
-    inline void broadcast(const Elevator::Incoming& message); // Рассылка сообщений.
-    void print_info(); // Вывод информации.
+    void broadcast(const Elevator::Incoming& message); // Рассылка сообщения всем лифтам.
+    void post(size_t elevator, const Elevator::Incoming& message); // Постановка сообщения в очередь лифта.
+    void flush(size_t elevator); // Отправка накопленных сообщений лифту.
+    void flush(); // Отправка накопленных сообщений всем лифтам.
+    void collect(size_t elevator, std::vector<Elevator::Outcoming>& outcomings); // Получение всех накопившихся ответов лифта (без ожидания).
+    Elevator::Outcoming receive(size_t elevator); // Получение очередного ответа лифта (с применением событий состава пассажиров).
+    void manifest(size_t elevator, const Elevator::Outcoming& event); // Применение события Boarded или Alighted к зеркалу.
+    Elevator::Outcoming exchange(size_t elevator, ssize_t floor, Elevator::Direction direction); // Обмен пассажирами с лифтом, ожидающим на этаже.
+    std::string elevator_string(size_t elevator); // Строка состояния лифта для отрисовки.
+    void render(bool force = false); // Публикация кадра, если его ожидает поток отрисовки (или принудительно).
 
 private:
 
@@ -0,0 +1,53 @@
+#ifndef COUNTDOWN
+#define COUNTDOWN
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+////////////////   Countdown    ////////////////
+// Барьер завершения шага: ожидающий поток задаёт число участников шага, каждый участник по завершении
+// вызывает arrive(), а wait() возвращается, когда завершились все. Записи участников до arrive() видны после wait().
+// Ожидающий сначала некоторое время крутится и только затем засыпает до прихода последнего участника.
+class Countdown
+{
+public:
+    void reset(size_t participants) { remaining.store(participants, std::memory_order_relaxed); } // Начать шаг (до рассылки работы участникам).
+
+    void arrive() // Участник завершил шаг.
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) { return; }
+
+        // Последний участник будит ожидающего, если тот заснул.
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_one();
+    }
+    void wait() // Дождаться завершения шага всеми участниками.
+    {
+        // На одном ядре участники не могут завершиться, пока ожидающий крутится, поэтому он сразу засыпает.
+        static const size_t spins = (std::thread::hardware_concurrency() > 1) ? spin_limit : 0;
+        for (size_t attempt = 0; attempt < spins; ++attempt)
+        {
+            if (remaining.load(std::memory_order_acquire) == 0) { return; }
+            if (attempt < 32) { std::atomic_signal_fence(std::memory_order_seq_cst); }
+            else { std::this_thread::yield(); }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+protected:
+    static constexpr size_t spin_limit = 128; // Число проверок до засыпания.
+
+    alignas(64) std::atomic<size_t> remaining{0}; // Число участников, ещё не завершивших шаг.
+    std::mutex mutex;
+    std::condition_variable condition;
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef DISPATCHER
+#define DISPATCHER
+
+#include <vector>
+
+#include "Elevator.hpp"
+#include "ElevatorFleet.hpp"
+#include "FloorMask.hpp"
+
+////////////////   Dispatcher   ////////////////
+// Централизованное распределение вызовов с этажей: каждый вызов назначается одному лифту
+// с наименьшим оценочным временем прибытия.
+// Лифты с одинаковыми наборами обслуживаемых этажей образуют группу; вызов с этажа назначается
+// по одному лифту в каждой группе, обслуживающей нужных людей.
+class Dispatcher
+{
+public:
+    static constexpr ssize_t unassigned = -1; // Вызов не назначен ни одному лифту.
+
+    Dispatcher(size_t floors_number = 0, const std::vector<Elevator::Settings>& init_settings = {}, const std::vector<FloorMask>& masks = {});
+
+    size_t groups() const { return groups_masks.size(); } // Число групп лифтов.
+    size_t group(size_t elevator) const { return elevators_groups[elevator]; } // Группа лифта.
+    const std::vector<size_t>& members(size_t group) const { return groups_members[group]; } // Лифты группы.
+    bool serves(size_t group, ssize_t floor) const { return groups_masks[group].contains(floor); } // Обслуживает ли группа этаж.
+    const Elevator::Settings& settings(size_t elevator) const { return elevators_settings[elevator]; } // Параметры лифта.
+
+    ssize_t assigned(ssize_t floor, Elevator::Direction direction, size_t group = 0) const; // Лифт группы, которому назначен вызов.
+    // Назначить вызов лифту; expected - ожидаемый момент его прибытия.
+    void assign(ssize_t floor, Elevator::Direction direction, size_t elevator, tick_t expected);
+    void release(ssize_t floor, Elevator::Direction direction, size_t group = 0); // Снять назначение вызова в группе.
+
+    // Лифт группы с наименьшим оценочным временем прибытия.
+    size_t select(const ElevatorFleet& fleet, ssize_t floor, Elevator::Direction direction, size_t group = 0) const;
+    // Переназначение вызова задержавшегося лифта: вызов пересматривается, только если лифт прибудет позже ожидаемого,
+    // и передаётся другому лифту группы (кроме лифта, у которого он был отнят последним), если тот прибудет раньше
+    // с запасом в одну остановку. Возвращает новый лифт или unassigned.
+    ssize_t reassign(const ElevatorFleet& fleet, tick_t timestamp, size_t elevator, ssize_t floor, Elevator::Direction direction);
+    // Назначение по пунктам назначения: каждый ожидающий назначается лифту при прибытии на этаж. Люди с одного этажа
+    // в одном направлении группируются по секторам этажей назначения: группа набирается в один лифт, пока в нём хватает
+    // мест с учётом уже назначенных людей, затем для неё выбирается следующий лифт.
+    void sectorize(size_t sectors_number = 0); // Разбиение этажей на секторы (0 - по вместимости лифтов).
+    size_t sectors() const { return sectors_number; }
+    size_t sector(ssize_t destination) const { return static_cast<size_t>(destination) * sectors_number / floors; } // Сектор этажа назначения.
+    // Назначение человека лифту; is_called - требуется ли отправить лифту вызов на этаж.
+    size_t assign_person(const ElevatorFleet& fleet, ssize_t floor, Elevator::Direction direction, ssize_t destination, bool& is_called);
+    void release_person(size_t elevator) { --reserved[elevator]; } // Назначенный лифту человек вошёл в него или переназначается.
+    bool is_calling(size_t elevator, ssize_t floor, Elevator::Direction direction) const; // Есть ли у лифта невыполненный вызов на этаж.
+    void arrive(size_t elevator, ssize_t floor, Elevator::Direction direction); // Лифт прибыл за назначенными ему людьми.
+    void depart(size_t elevator, ssize_t floor); // Лифт отбыл: группы, за которыми он прибывал, больше не набираются в него.
+
+    // Оценочное время прибытия лифта по вызову.
+    tick_t estimate(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const;
+    // Оценочное время прибытия лифта с учётом остановки по самому вызову (без штрафа за заполненность).
+    tick_t arrival(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const;
+    // Вызовы, назначенные лифту.
+    void calls(size_t elevator, std::vector<std::pair<ssize_t, Elevator::Direction>>& result) const;
+
+    // Запись и восстановление назначений (параметры лифтов не сохраняются).
+    void store(Checkpoint& checkpoint) const;
+    bool restore(Checkpoint::Reader& reader);
+
+protected:
+    std::vector<Elevator::Settings> elevators_settings; // Параметры каждого лифта.
+    std::vector<size_t> elevators_groups;               // Группа каждого лифта.
+    std::vector<FloorMask> groups_masks;                // Обслуживаемые этажи каждой группы.
+    std::vector<std::vector<size_t>> groups_members;    // Лифты каждой группы.
+    size_t floors = 0;
+
+    std::vector<ssize_t> floor_assignments[2]; // Назначенные лифты для вызовов вверх и вниз на каждом этаже (по группам подряд).
+    std::vector<tick_t> floor_expected[2];     // Ожидаемые моменты прибытия назначенных лифтов.
+    std::vector<ssize_t> floor_previous[2];    // Лифты, у которых вызовы были отняты последними.
+    size_t sectors_number = 0;
+    std::vector<ssize_t> sector_assignments[2]; // Лифты, набирающие группы вверх и вниз на каждом этаже (по секторам подряд).
+    std::vector<uint64_t> reserved;             // Число назначенных каждому лифту, но ещё не вошедших людей.
+    std::vector<CallRegistry> elevator_calls;  // Назначенные каждому лифту вызовы.
+
+    // Оценочное время прибытия без штрафа за заполненность.
+    tick_t _travel(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const;
+    tick_t _stop(size_t elevator) const // Время одной остановки лифта.
+    {
+        const Elevator::Settings& settings = elevators_settings[elevator];
+        return settings.open + settings.idle + settings.close;
+    }
+
+    static size_t _index(Elevator::Direction direction) { return (direction == Elevator::Direction::Upwards) ? 0 : 1; }
+    static size_t _group(Elevator::Direction direction) { return static_cast<size_t>(direction); }
+
+private:
+
+};
+
+#endif
@@ -8,15 +8,22 @@
 #include <atomic>
 
 #include "Messaging.hpp"
+#include "Countdown.hpp"
+#include "CallRegistry.hpp"
+#include "Checkpoint.hpp"
+#include "Trace.hpp"
 
 
 ////////////////     Person     ////////////////
 // Структура для описания одного человека.
 struct Person
 {
-    tick_t timestamp;    // Время прибытия.
-    ssize_t origin;      // Этаж прибытия.
-    ssize_t destination; // Этаж-пункт назначения.
+    tick_t timestamp;               // Время прибытия.
+    ssize_t origin;                 // Этаж прибытия.
+    ssize_t destination;            // Этаж-пункт назначения.
+    tick_t boarded = 0;             // Время входа в лифт.
+    tick_t alighted = 0;            // Время выхода из лифта.
+    ssize_t final_destination = -1; // Конечный этаж поездки с пересадками (-1 - этаж назначения и есть конечный).
 };
 
 ////////////////    Elevator    ////////////////
@@ -64,6 +71,8 @@ public:
             Cancel,    // Вызов отменён.
             Embark,    // Попытка входа человека.
             Disembark, // Попытка выхода человека (ага, пытайся, этот лифт кодил самый альтернативно одарённый программист ФУПМа).
+            Stop,      // Завершение работы.
+            Exchange,  // Обмен пассажирами за одну остановку: выход всех прибывших и посадка предложенных людей.
         };
 
         Code code;           // Код сообщения.
@@ -72,6 +81,7 @@ public:
         Direction direction; // [Call]:  Направление вызова.
         Person person;       // [Enter]: Входящий человек.
         bool response;       // Требуется ли ответ.
+        uint32_t offered_count = 0; // [Exchange]: Число предложенных к посадке людей (первые offered_count в offers).
     };
 
     struct Outcoming : public Message
@@ -87,6 +97,9 @@ public:
             InProgress, // В процессе.
             Empty,      // Пустой.
             Full,       // Полный.
+            Boarded,    // Человек вошёл (событие изменения состава пассажиров).
+            Alighted,   // Человек вышел (событие изменения состава пассажиров).
+            Exchanged,  // Обмен пассажирами выполнен (вышедшие и вошедшие люди сообщаются событиями Alighted и Boarded перед ответом).
         };
 
         Code code;           // Код сообщения.
@@ -94,8 +107,15 @@ public:
         tick_t progress;     // Прогресс.
         Direction direction; // Направление вызова.
         ssize_t floor;       // Номер этажа.
+        tick_t remaining;    // Время до ближайшего изменения состояния (never, если без вызовов ничего не изменится).
+        Person person;       // [Boarded, Alighted]: Вошедший или вышедший человек.
+        uint32_t alighted_count; // [Exchanged]: Число вышедших людей.
+        uint32_t boarded_count;  // [Exchanged]: Число вошедших людей.
     };
 
+    // Значение remaining для лифта, состояние которого без новых вызовов не изменится.
+    static constexpr tick_t never = UINT64_MAX;
+
     // Сообщения.
     Messaging<Incoming> inbox;
     Messaging<Outcoming> outbox;
@@ -107,14 +127,28 @@ public:
     // Работа.
     std::atomic<bool> working = true;
 
-    Elevator(const Settings& init_settings);
-    Elevator(const Elevator& elevator);
+    // Барьер завершения тика: если задан, после отправки всех ответов на сообщение, требующее ответа,
+    // лифт отмечается на барьере (при работе в отдельном потоке или в пуле).
+    Countdown* countdown = nullptr;
+
+    // Люди, предлагаемые к посадке при обмене пассажирами, в порядке очереди: буфер владельца лифта на его вместимость,
+    // задаётся до запуска и не перераспределяется; владелец заполняет его перед отправкой Exchange и не меняет до ответа.
+    const Person* offers = nullptr;
+
+    Elevator(const Settings& init_settings, size_t floors_number);
+    Elevator(const Elevator& elevator) = delete; // Состояние переносится только через контрольные точки (store/restore).
     ~Elevator();
 
     void loop(); // Цикл работы.
-    std::vector<Person> get_persons(); // Получение массива находящихся в лифте людей.
+    const std::vector<Outcoming>& step(const Incoming& incoming); // Синхронная обработка сообщения; ответы действительны до следующего вызова.
+    bool poll(); // Обработка всех уже поступивших сообщений без ожидания (для выполнения в пуле потоков).
+
+    // Запись и восстановление состояния (только пока лифт не обрабатывает сообщения). Параметры лифта не сохраняются:
+    // восстановленный лифт работает с параметрами, заданными при создании.
+    void store(Checkpoint& checkpoint) const;
+    bool restore(Checkpoint::Reader& reader);
 
-    Elevator& operator=(const Elevator& elevator);
+    Elevator& operator=(const Elevator& elevator) = delete;
 
 protected:
     // Настройки.
@@ -127,6 +161,7 @@ protected:
     // Состояние.
     State state = State::Waiting;
     tick_t progress = 0;
+    tick_t dwell = 0; // Длительность текущей посадки или высадки.
 
     // Движение.
     ssize_t floor = 0;
@@ -135,14 +170,20 @@ protected:
     ssize_t destination = 0;
     Direction direction = Direction::None;
 
-    // Присутствующие в лифте люди, отсортированные по этажам.
-    std::multimap<ssize_t, Person> floor_person;
-    std::shared_mutex mutex_floor_person;
+    // Присутствующие в лифте люди в порядке входа (память выделяется по вместимости при создании)
+    // и число людей, выходящих на каждом этаже.
+    std::vector<Person> persons;
+    std::vector<uint32_t> destination_counts;
+
+    // Ответы на обрабатываемое сообщение.
+    std::vector<Outcoming> outgoing;
 
     // Поступившие вызовы.
-    std::map<Direction, std::set<ssize_t>> calls;
+    CallRegistry calls;
 
+    void handle(const Incoming& incoming); // Обработка одного сообщения.
     bool switch_state(); // Изменить состояние лифта.
+    tick_t next_event(); // Время до ближайшего изменения состояния.
     bool _switch_closest();
     bool _switch_selected();
     bool _switch_not_selected();
@@ -153,6 +194,12 @@ protected:
     // Отменить вызов.
     void erase_call(ssize_t floor, Direction direction);
 
+    // Этаж в пределах здания.
+    bool is_floor(ssize_t floor_number) const { return (floor_number >= 0) && (static_cast<size_t>(floor_number) < destination_counts.size()); }
+
+    // Номер группы вызовов в реестре для направления.
+    static size_t _group(Direction direction) { return static_cast<size_t>(direction); }
+
     // Получить шаблон исходящего сообщения.
     Outcoming _create_outcoming(Outcoming::Code = Outcoming::Code::Success);
 
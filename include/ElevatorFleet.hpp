@@ -0,0 +1,52 @@
+#ifndef ELEVATOR_FLEET
+#define ELEVATOR_FLEET
+
+#include <vector>
+
+#include "Elevator.hpp"
+
+//////////////// ElevatorFleet /////////////////
+// Представление состояния всех лифтов на стороне контроллера в виде структуры массивов.
+// Часто используемые поля каждого лифта хранятся в непрерывных массивах, поэтому продвижение времени
+// выполняется одним векторизуемым проходом, а тики рассылаются только лифтам, у которых наступает смена состояния.
+class ElevatorFleet
+{
+public:
+    // Значение remaining для лифта, состояние которого без новых вызовов не изменится.
+    static constexpr uint32_t never = UINT32_MAX;
+
+    ElevatorFleet(size_t elevators_number = 0);
+
+    size_t size() const; // Число лифтов.
+
+    void update(size_t elevator, const Elevator::Outcoming& outcoming, tick_t timestamp); // Учёт последнего ответа лифта.
+    void touch(size_t elevator); // Лифту отправлен вызов: простаивающий лифт должен получить тик на следующем шаге.
+
+    tick_t next_event() const; // Время до ближайшей смены состояния среди всех лифтов (Elevator::never, если таких нет).
+    void advance(tick_t delta, std::vector<size_t>& due); // Продвижение времени и получение номеров лифтов, у которых меняется состояние.
+
+    tick_t elapsed(size_t elevator, tick_t timestamp) const; // Время, не переданное лифту с момента последнего тика.
+    tick_t current_progress(size_t elevator, tick_t timestamp) const; // Текущий прогресс с учётом непереданного времени.
+
+    void store(Checkpoint& checkpoint) const; // Запись в контрольную точку.
+    bool restore(Checkpoint::Reader& reader); // Чтение из контрольной точки (число лифтов должно совпадать).
+
+    // Часто используемые поля.
+    std::vector<uint32_t> remaining;      // Время до ближайшей смены состояния.
+    std::vector<uint8_t> crossed;         // Признак смены состояния на текущем шаге.
+
+    // Последнее известное состояние лифтов.
+    std::vector<Elevator::State> state;
+    std::vector<Elevator::Direction> direction;
+    std::vector<ssize_t> floor;
+    std::vector<tick_t> progress;         // Прогресс на момент последнего тика.
+    std::vector<tick_t> synchronized;     // Время последнего тика, переданного лифту.
+    std::vector<uint64_t> load;           // Число пассажиров (по подтверждённым посадкам и высадкам).
+
+protected:
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef EXECUTOR
+#define EXECUTOR
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+////////////////    Executor    ////////////////
+// Пул рабочих потоков с перехватом задач.
+// Задачи пронумерованы от 0 до tasks_number - 1; одна и та же задача никогда не выполняется двумя потоками одновременно,
+// а повторная постановка во время выполнения приводит к ещё одному запуску после завершения текущего.
+class Executor
+{
+public:
+    Executor(size_t workers_number, size_t tasks_number, const std::function<void(size_t)>& init_task);
+    ~Executor();
+
+    void submit(size_t task); // Запланировать выполнение задачи.
+
+    size_t size() const; // Число рабочих потоков.
+
+protected:
+    // Состояния задач.
+    enum TaskState : uint8_t
+    {
+        Idle,        // Не запланирована.
+        Scheduled,   // Находится в очереди.
+        Running,     // Выполняется.
+        Rescheduled, // Выполняется и должна быть запущена повторно.
+    };
+
+    struct Worker
+    {
+        std::deque<size_t> tasks; // Очередь задач потока.
+        std::mutex mutex_tasks;
+    };
+
+    std::function<void(size_t)> task;
+    std::unique_ptr<std::atomic<uint8_t>[]> task_states;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> workers_threads;
+
+    // Ожидание задач.
+    std::atomic<size_t> queued{0};   // Число задач в очередях.
+    std::atomic<size_t> sleeping{0}; // Число спящих потоков.
+    std::atomic<bool> working{true};
+    std::mutex mutex_sleeping;
+    std::condition_variable condition_sleeping;
+
+    void loop(size_t worker); // Цикл работы потока.
+    void push(size_t worker, size_t task); // Постановка задачи в очередь потока.
+    bool pop(size_t worker, size_t& task); // Извлечение задачи из своей очереди или перехват из чужой.
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef FLOOR_MASK
+#define FLOOR_MASK
+
+#include <cinttypes>
+#include <cstddef>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+////////////////   FloorMask   /////////////////
+// Множество этажей, обслуживаемых лифтом (битовое множество).
+class FloorMask
+{
+public:
+    FloorMask(size_t floors_number = 0, bool is_full = true); // Все этажи или ни одного.
+
+    // Разбор списка этажей: "all" или перечисление этажей и диапазонов через запятую ("0,40-59").
+    static bool parse(const std::string& specification, size_t floors_number, FloorMask& mask);
+
+    void insert(ssize_t floor); // Добавить этаж.
+    bool contains(ssize_t floor) const // Обслуживается ли этаж.
+    {
+        if ((floor < 0) || (static_cast<size_t>(floor) >= floors)) { return false; }
+        return (words[static_cast<size_t>(floor) >> 6] >> (floor & 63)) & 1;
+    }
+    bool full() const; // Обслуживаются ли все этажи.
+    bool empty() const; // Не обслуживается ли ни один этаж.
+    size_t size() const { return floors; } // Число этажей здания.
+
+    bool operator==(const FloorMask& mask) const { return (floors == mask.floors) && (words == mask.words); }
+
+protected:
+    std::vector<uint64_t> words;
+    size_t floors;
+
+private:
+
+};
+
+#endif
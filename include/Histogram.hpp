@@ -0,0 +1,116 @@
+#ifndef HISTOGRAM
+#define HISTOGRAM
+
+#include <cinttypes>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+#include "Checkpoint.hpp"
+
+////////////////   Histogram   /////////////////
+// Гистограмма с логарифмически-линейными корзинами (в духе HDR Histogram): на каждый интервал [2^e, 2^(e+1))
+// приходится sub_count корзин одинаковой ширины, поэтому относительная погрешность не превосходит 1/sub_count,
+// а память фиксирована и не зависит от числа записанных значений.
+class Histogram
+{
+public:
+    static constexpr size_t sub_bits = 5;                // Число бит точности.
+    static constexpr size_t sub_count = 1 << sub_bits;   // Число корзин на каждый интервал.
+    static constexpr size_t buckets_number = (64 - sub_bits + 1) * sub_count;
+
+    void record(uint64_t value, uint64_t count = 1) // Записать значение (count раз).
+    {
+        if (count == 0) { return; }
+        buckets[index(value)] += count;
+        if ((total == 0) || (value < minimum)) { minimum = value; }
+        if (value > maximum) { maximum = value; }
+        total += count;
+        sum += static_cast<long double>(value) * count;
+    }
+
+    uint64_t count() const { return total; } // Число записанных значений.
+    uint64_t min() const { return minimum; }
+    uint64_t max() const { return maximum; }
+    double mean() const { return total ? static_cast<double>(sum / total) : 0.0; }
+    uint64_t percentile(double percent) const // Значение, не меньше которого не более (100 - percent)% записанных.
+    {
+        if (total == 0) { return 0; }
+        uint64_t target = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+        if (target == 0) { target = 1; }
+        if (target > total) { target = total; }
+
+        uint64_t cumulative = 0;
+        for (size_t bucket = 0; bucket < buckets_number; ++bucket)
+        {
+            cumulative += buckets[bucket];
+            if (cumulative >= target)
+            {
+                // Верхняя граница корзины, ограниченная наблюдавшимися крайними значениями.
+                uint64_t value = upper(bucket);
+                if (value > maximum) { value = maximum; }
+                if (value < minimum) { value = minimum; }
+                return value;
+            }
+        }
+        return maximum;
+    }
+
+    void store(Checkpoint& checkpoint) const // Запись в контрольную точку (только непустые корзины).
+    {
+        std::vector<uint32_t> indices;
+        std::vector<uint64_t> counts;
+        for (size_t bucket = 0; bucket < buckets_number; ++bucket)
+        {
+            if (buckets[bucket] == 0) { continue; }
+            indices.push_back(static_cast<uint32_t>(bucket));
+            counts.push_back(buckets[bucket]);
+        }
+        checkpoint.write(indices);
+        checkpoint.write(counts);
+        checkpoint.write(total);
+        checkpoint.write(minimum);
+        checkpoint.write(maximum);
+        checkpoint.write(sum);
+    }
+    bool restore(Checkpoint::Reader& reader) // Чтение из контрольной точки.
+    {
+        std::vector<uint32_t> indices;
+        std::vector<uint64_t> counts;
+        if (!reader.read(indices) || !reader.read(counts) || (indices.size() != counts.size())) { return reader.fail(); }
+        buckets.fill(0);
+        for (size_t entry = 0; entry < indices.size(); ++entry)
+        {
+            if (indices[entry] >= buckets_number) { return reader.fail(); }
+            buckets[indices[entry]] = counts[entry];
+        }
+        return reader.read(total) && reader.read(minimum) && reader.read(maximum) && reader.read(sum);
+    }
+
+protected:
+    std::array<uint64_t, buckets_number> buckets = {};
+    uint64_t total = 0;
+    uint64_t minimum = 0;
+    uint64_t maximum = 0;
+    long double sum = 0;
+
+    static size_t index(uint64_t value) // Номер корзины для значения.
+    {
+        if (value < sub_count) { return static_cast<size_t>(value); }
+        size_t exponent = 63 - __builtin_clzll(value);
+        size_t shift = exponent - sub_bits;
+        return (shift + 1) * sub_count + static_cast<size_t>((value >> shift) - sub_count);
+    }
+    static uint64_t upper(size_t bucket) // Наибольшее значение, попадающее в корзину.
+    {
+        if (bucket < sub_count) { return bucket; }
+        size_t shift = bucket / sub_count - 1;
+        uint64_t lower = static_cast<uint64_t>(sub_count + bucket % sub_count) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+
+};
+
+#endif
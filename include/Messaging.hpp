@@ -3,13 +3,17 @@
 
 #include <cinttypes>
 #include <queue>
+#include <vector>
 #include <shared_mutex>
 #include <condition_variable>
+#include <iterator>
 
 #include <thread>
 #include <iostream>
 using namespace std::chrono_literals;
 
+#include "MessagingStatistics.hpp"
+
 // Типы данных.
 typedef uint64_t tick_t; // Тип данных для хранения количества тиков.
 typedef int64_t mid_t;   // Message ID. ID сообщения.
@@ -23,66 +27,110 @@ struct Message
 };
 
 
-////////////////   Messaging   /////////////////
+//////////////// QueueMessaging /////////////////
 // Интерфейс для межпоточного общения путём сообщений.
+// Реализация на очереди, защищённой мьютексом.
 template<typename T>
-class Messaging
+class QueueMessaging
 {
 public:
-    Messaging()
+    QueueMessaging()
     {
         // ...
     }
-    Messaging(const Messaging& messaging)
+    QueueMessaging(const QueueMessaging& messaging)
     {
         messages = messaging.messages;
+        #ifdef MESSAGING_STATISTICS
+        send_times = messaging.send_times;
+        #endif
     }
-    ~Messaging()
+    ~QueueMessaging()
     {
         // ...
     }
 
+    static constexpr size_t capacity() { return SIZE_MAX; } // Число сообщений, вмещаемых без ожидания получателя (не ограничено).
+
     void send(const T& message) // Отправить сообщение.
     {
-        std::unique_lock<std::shared_mutex> lock(mutex_messages);
-        messages.push(message);
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
+        push(message);
+        #ifdef MESSAGING_STATISTICS
+        statistics_messages.sent(1, messages.size());
+        #endif
+        condition_messages.notify_one();
+    }
+    template<typename Iterator>
+    void send_batch(Iterator begin, Iterator end) // Отправить набор сообщений с одной блокировкой и одним пробуждением.
+    {
+        if (begin == end) { return; }
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
+        for (Iterator iterator = begin; iterator != end; ++iterator)
+        { push(*iterator); }
+        #ifdef MESSAGING_STATISTICS
+        statistics_messages.sent(std::distance(begin, end), messages.size());
+        #endif
         condition_messages.notify_one();
     }
     T receive() // Принять сообщение.
     {
-        T message;
-        while (true)
-        {
-            std::unique_lock<std::shared_mutex> lock(mutex_messages);
-            if (messages.empty() == false)
-            {
-                // Получение верхнего сообщения.
-                message = messages.front();
-                messages.pop();
-                break;
-            }
-            // Ожидаение в случае отсутствия сообщений.
-            else
-            { condition_messages.wait(lock); }
-        }
-        return message;
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
+        // Ожидаение в случае отсутствия сообщений.
+        while (messages.empty())
+        { wait(lock); }
+
+        // Получение верхнего сообщения.
+        return pop();
+    }
+    size_t receive_all(std::vector<T>& received) // Дождаться сообщений и забрать все накопившиеся (дописываются в конец received).
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
+        // Ожидаение в случае отсутствия сообщений.
+        while (messages.empty())
+        { wait(lock); }
+
+        size_t count = messages.size();
+        while (!messages.empty())
+        { received.push_back(pop()); }
+        return count;
+    }
+    size_t try_receive_all(std::vector<T>& received) // Забрать все накопившиеся сообщения без ожидания (дописываются в конец received).
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
+        size_t count = messages.size();
+        while (!messages.empty())
+        { received.push_back(pop()); }
+        return count;
     }
     bool try_receive(T& message) // Попытка принять сообщение.
     {
-        std::unique_lock<std::shared_mutex> lock(mutex_messages);
+        std::unique_lock<std::shared_mutex> lock(mutex_messages, std::defer_lock);
+        acquire(lock);
         if (messages.empty() == false)
         {
             // Получение верхнего сообщения.
-            message = messages.front();
-            messages.pop();
+            message = pop();
             return true;
         }
         else { return false; }
     }
 
-    Messaging<T>& operator=(const Messaging<T>& messaging)
+    #ifdef MESSAGING_STATISTICS
+    MessagingStatistics::Counters statistics() const { return statistics_messages.snapshot(); } // Счётчики почтового ящика.
+    #endif
+
+    QueueMessaging<T>& operator=(const QueueMessaging<T>& messaging)
     {
         messages = messaging.messages;
+        #ifdef MESSAGING_STATISTICS
+        send_times = messaging.send_times;
+        #endif
         return *this;
     }
 
@@ -92,8 +140,59 @@ protected:
     std::shared_mutex mutex_messages;
     std::condition_variable_any condition_messages;
 
+    #ifdef MESSAGING_STATISTICS
+    std::queue<uint64_t> send_times; // Моменты отправки сообщений, находящихся в очереди.
+    MessagingStatistics statistics_messages;
+    #endif
+
+    void acquire(std::unique_lock<std::shared_mutex>& lock) // Захват мьютекса (с учётом ожиданий при сборе статистики).
+    {
+        #ifdef MESSAGING_STATISTICS
+        if (lock.try_lock()) { return; }
+        statistics_messages.contention();
+        #endif
+        lock.lock();
+    }
+    void wait(std::unique_lock<std::shared_mutex>& lock) // Ожидание сообщений.
+    {
+        condition_messages.wait(lock);
+        #ifdef MESSAGING_STATISTICS
+        if (messages.empty()) { statistics_messages.empty_wakeup(); }
+        #endif
+    }
+    void push(const T& message) // Постановка сообщения в очередь (под мьютексом).
+    {
+        messages.push(message);
+        #ifdef MESSAGING_STATISTICS
+        send_times.push(MessagingStatistics::now());
+        #endif
+    }
+    T pop() // Извлечение сообщения из очереди (под мьютексом).
+    {
+        T message = messages.front();
+        messages.pop();
+        #ifdef MESSAGING_STATISTICS
+        statistics_messages.received(send_times.front(), MessagingStatistics::now());
+        send_times.pop();
+        #endif
+        return message;
+    }
+
 private:
 
 };
 
+////////////////   Messaging   /////////////////
+// Используемая реализация выбирается при сборке: MESSAGING_RING - кольцевой буфер без блокировок
+// (один отправитель и один получатель), иначе - очередь с мьютексом.
+#include "RingMessaging.hpp"
+
+#ifdef MESSAGING_RING
+template<typename T>
+using Messaging = RingMessaging<T>;
+#else
+template<typename T>
+using Messaging = QueueMessaging<T>;
+#endif
+
 #endif
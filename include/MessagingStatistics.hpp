@@ -0,0 +1,97 @@
+#ifndef MESSAGING_STATISTICS_HPP
+#define MESSAGING_STATISTICS_HPP
+
+#include <cinttypes>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+//////////////// MessagingStatistics /////////////////
+// Счётчики почтового ящика, собираемые при сборке с MESSAGING_STATISTICS (иначе не используются вовсе).
+// Отправитель и получатель обновляют их из разных потоков, поэтому счётчики атомарные с ослабленным порядком.
+class MessagingStatistics
+{
+public:
+    // Снимок счётчиков (допускает сложение по нескольким почтовым ящикам).
+    struct Counters
+    {
+        uint64_t sent = 0;          // Отправлено сообщений.
+        uint64_t received = 0;      // Получено сообщений.
+        uint64_t high_water = 0;    // Наибольшая глубина очереди.
+        uint64_t latency_total = 0; // Суммарное время от отправки до получения (нс).
+        uint64_t latency_max = 0;   // Наибольшее время от отправки до получения (нс).
+        uint64_t contended = 0;     // Ожидания захваченного мьютекса (или освобождения места в кольцевом буфере).
+        uint64_t empty_wakeups = 0; // Пробуждения получателя, не обнаружившие сообщений.
+
+        Counters& operator+=(const Counters& counters)
+        {
+            sent += counters.sent;
+            received += counters.received;
+            high_water = std::max(high_water, counters.high_water);
+            latency_total += counters.latency_total;
+            latency_max = std::max(latency_max, counters.latency_max);
+            contended += counters.contended;
+            empty_wakeups += counters.empty_wakeups;
+            return *this;
+        }
+        void print(std::ostream& output) const // Вывод в формате JSON.
+        {
+            output << "{\"sent\": " << sent
+                   << ", \"received\": " << received
+                   << ", \"high_water\": " << high_water
+                   << ", \"latency_mean_ns\": " << (received ? latency_total / received : 0)
+                   << ", \"latency_max_ns\": " << latency_max
+                   << ", \"contended\": " << contended
+                   << ", \"empty_wakeups\": " << empty_wakeups << "}";
+        }
+    };
+
+    static uint64_t now() // Текущее время в наносекундах (монотонные часы).
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void sent(uint64_t count, uint64_t depth) // Отправлено count сообщений, глубина очереди стала depth.
+    {
+        counters_sent.fetch_add(count, std::memory_order_relaxed);
+        uint64_t current = high_water.load(std::memory_order_relaxed);
+        while ((depth > current) && !high_water.compare_exchange_weak(current, depth, std::memory_order_relaxed));
+    }
+    void received(uint64_t sent_time, uint64_t received_time) // Получено сообщение, отправленное в момент sent_time.
+    {
+        uint64_t latency = (received_time > sent_time) ? received_time - sent_time : 0;
+        counters_received.fetch_add(1, std::memory_order_relaxed);
+        latency_total.fetch_add(latency, std::memory_order_relaxed);
+        uint64_t current = latency_max.load(std::memory_order_relaxed);
+        while ((latency > current) && !latency_max.compare_exchange_weak(current, latency, std::memory_order_relaxed));
+    }
+    void contention() { contended.fetch_add(1, std::memory_order_relaxed); }
+    void empty_wakeup() { empty_wakeups.fetch_add(1, std::memory_order_relaxed); }
+
+    Counters snapshot() const
+    {
+        Counters counters;
+        counters.sent = counters_sent.load(std::memory_order_relaxed);
+        counters.received = counters_received.load(std::memory_order_relaxed);
+        counters.high_water = high_water.load(std::memory_order_relaxed);
+        counters.latency_total = latency_total.load(std::memory_order_relaxed);
+        counters.latency_max = latency_max.load(std::memory_order_relaxed);
+        counters.contended = contended.load(std::memory_order_relaxed);
+        counters.empty_wakeups = empty_wakeups.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+protected:
+    std::atomic<uint64_t> counters_sent{0};
+    std::atomic<uint64_t> counters_received{0};
+    std::atomic<uint64_t> high_water{0};
+    std::atomic<uint64_t> latency_total{0};
+    std::atomic<uint64_t> latency_max{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> empty_wakeups{0};
+
+private:
+
+};
+
+#endif
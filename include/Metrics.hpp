@@ -0,0 +1,63 @@
+#ifndef METRICS
+#define METRICS
+
+#include <iostream>
+#include <vector>
+
+#include "Elevator.hpp"
+#include "Histogram.hpp"
+
+////////////////    Metrics    /////////////////
+// Потоковые показатели прогона с ограниченной памятью: время ожидания и поездки людей,
+// число доставленных людей за окно времени и доли времени, проведённые каждым лифтом в каждом состоянии.
+class Metrics
+{
+public:
+    static constexpr size_t states_number = static_cast<size_t>(Elevator::State::Disembarking) + 1;
+
+    Metrics(size_t elevators_number = 0, tick_t init_window = 100);
+
+    void boarded(const Person& person); // Человек вошёл в лифт (учёт времени ожидания).
+    void alighted(const Person& person); // Человек вышел из лифта (учёт времени поездки и пропускной способности).
+    void state(size_t elevator, Elevator::State state, tick_t timestamp); // Лифт находится в состоянии state с момента timestamp.
+    void stopped(size_t elevator, uint64_t passing); // Лифт остановился на этаже; passing - число пассажиров, едущих дальше.
+
+    void print(std::ostream& output, tick_t timestamp) const; // Вывод показателей на момент timestamp в формате JSON.
+
+    const Histogram& waits() const { return wait_times; }
+    const Histogram& rides() const { return ride_times; }
+    const Histogram& throughput() const { return window_counts; }
+    double share(size_t elevator, Elevator::State state, tick_t timestamp) const; // Доля времени лифта в состоянии на момент timestamp.
+    double fleet_share(Elevator::State state, tick_t timestamp) const; // Та же доля в среднем по парку.
+    uint64_t stops() const; // Общее число остановок лифтов.
+    double stops_per_ride() const; // Среднее число промежуточных остановок за поездку.
+
+    void store(Checkpoint& checkpoint) const; // Запись в контрольную точку.
+    bool restore(Checkpoint::Reader& reader); // Чтение из контрольной точки.
+
+protected:
+    Histogram wait_times;       // Время от прибытия на этаж до входа в лифт.
+    Histogram ride_times;       // Время от входа в лифт до выхода.
+
+    // Пропускная способность: число доставленных людей за каждое завершённое окно.
+    tick_t window;
+    uint64_t window_index = 0;  // Номер текущего окна.
+    uint64_t window_count = 0;  // Число доставленных в текущем окне.
+    Histogram window_counts;    // Распределение по завершённым окнам.
+
+    // Остановки: число остановок каждого лифта и суммарное число промежуточных остановок всех пассажиров.
+    std::vector<uint64_t> stops_counts;
+    uint64_t passing_count = 0;
+
+    // Время в состояниях: для каждого лифта - накопленное время по состояниям, текущее состояние и момент входа в него.
+    std::vector<tick_t> state_ticks;
+    std::vector<Elevator::State> states;
+    std::vector<tick_t> states_since;
+
+    static void print_histogram(std::ostream& output, const Histogram& histogram);
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef PARSING
+#define PARSING
+
+#include <charconv>
+#include <cstring>
+
+// Разбор числа: строка целиком должна быть записью значения типа T (без знака для беззнаковых типов).
+template<typename T>
+bool parse_number(const char* text, T& value)
+{
+    const char* end = text + std::strlen(text);
+    std::from_chars_result result = std::from_chars(text, end, value);
+    return (result.ptr != text) && (result.ptr == end) && (result.ec == std::errc());
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PASSENGER_QUEUES
+#define PASSENGER_QUEUES
+
+#include <cinttypes>
+#include <vector>
+
+#include "Elevator.hpp"
+
+//////////////// PassengerQueues ////////////////
+// Очереди ожидающих людей: на каждом этаже - отдельные очереди FIFO вверх и вниз.
+// Записи о людях компактны (этаж прибытия задаётся самой очередью) и берутся из общего пула,
+// очереди связаны индексами записей, освобождённые записи переиспользуются через список свободных.
+class PassengerQueues
+{
+public:
+    static constexpr uint32_t end = UINT32_MAX; // Отсутствие следующей записи.
+
+    struct Record
+    {
+        tick_t timestamp;          // Время прибытия.
+        uint32_t destination;      // Этаж-пункт назначения.
+        int32_t final_destination; // Конечный этаж поездки с пересадками.
+        uint32_t next;             // Следующая запись в очереди (или в списке свободных).
+        int32_t elevator;          // Лифт, которому назначен человек (при назначении по пунктам назначения, иначе -1).
+    };
+
+    PassengerQueues(size_t floors_number = 0);
+
+    size_t floors() const; // Число этажей.
+    size_t size() const; // Общее число ожидающих людей.
+    size_t size(ssize_t floor, Elevator::Direction direction) const; // Число людей в очереди.
+    bool empty() const { return waiting == 0; } // Нет ожидающих людей.
+    bool empty(ssize_t floor, Elevator::Direction direction) const { return queue(floor, direction).head == end; } // Пуста ли очередь.
+
+    uint32_t push(const Person& person, Elevator::Direction direction); // Постановка человека в конец очереди (возвращается его запись).
+    Person front(ssize_t floor, Elevator::Direction direction) const; // Первый человек в очереди.
+    void pop(ssize_t floor, Elevator::Direction direction); // Извлечение первого человека из очереди.
+
+    uint32_t first(ssize_t floor, Elevator::Direction direction) const { return queue(floor, direction).head; } // Обход очереди.
+    uint32_t next(uint32_t record) const { return records[record].next; }
+    const Record& record(uint32_t record) const { return records[record]; }
+    void assign(uint32_t record, ssize_t elevator) { records[record].elevator = static_cast<int32_t>(elevator); } // Назначить человека лифту.
+    Person person(ssize_t floor, uint32_t record) const; // Человек, описанный записью очереди этажа.
+    void erase(ssize_t floor, Elevator::Direction direction, uint32_t record, uint32_t previous); // Извлечение человека из середины очереди (previous - предыдущая запись или end).
+
+    void store(Checkpoint& checkpoint) const; // Запись в контрольную точку.
+    bool restore(Checkpoint::Reader& reader); // Чтение из контрольной точки.
+
+protected:
+    struct Queue
+    {
+        uint32_t head = end;
+        uint32_t tail = end;
+        uint32_t size = 0;
+    };
+
+    std::vector<Queue> queues;    // Очереди вверх и вниз для каждого этажа (попарно).
+    std::vector<Record> records;  // Пул записей.
+    uint32_t free_head = end;     // Список свободных записей.
+    size_t waiting = 0;           // Общее число ожидающих людей.
+
+    Queue& queue(ssize_t floor, Elevator::Direction direction) { return queues[2 * floor + (direction == Elevator::Direction::Downwards)]; }
+    const Queue& queue(ssize_t floor, Elevator::Direction direction) const { return queues[2 * floor + (direction == Elevator::Direction::Downwards)]; }
+
+private:
+
+};
+
+#endif
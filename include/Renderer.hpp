@@ -0,0 +1,54 @@
+#ifndef RENDERER
+#define RENDERER
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////    Renderer    ////////////////
+// Отрисовка модели в терминале в отдельном потоке с ограниченной частотой кадров.
+// Поток отрисовки запрашивает кадр, моделирование между тиками публикует согласованный снимок,
+// а в терминал пишутся только изменившиеся с прошлого кадра участки строк (одной записью на кадр).
+class Renderer
+{
+public:
+    typedef std::vector<std::string> Frame; // Кадр: строки экрана сверху вниз.
+
+    Renderer(std::ostream& init_output = std::cout, size_t frame_rate = 30);
+    ~Renderer();
+
+    bool requested() const; // Ожидает ли поток отрисовки новый кадр.
+    void publish(Frame& frame); // Передача кадра потоку отрисовки (содержимое frame обменивается с внутренним буфером).
+    void prompt(const std::string& text); // Вывод приглашения ввода под кадром.
+
+protected:
+    std::ostream& output;
+    std::chrono::steady_clock::duration period; // Минимальный интервал между кадрами.
+
+    Frame pending;     // Опубликованный, но ещё не отрисованный кадр.
+    Frame displayed;   // Кадр, находящийся на экране.
+    bool is_pending = false;
+    bool is_cleared = false; // Очищен ли экран перед первым кадром.
+    std::string buffer; // Накопление вывода кадра для одной записи.
+
+    std::atomic<bool> is_requested{true};
+    std::atomic<size_t> rows{0}; // Наибольшее число строк в опубликованных кадрах (приглашение ввода выводится ниже).
+    bool working = true;
+    std::mutex mutex_frame;
+    std::condition_variable condition_frame;
+    std::mutex mutex_output;
+    std::thread thread;
+
+    void loop(); // Цикл работы потока отрисовки.
+    void draw(const Frame& frame); // Вывод отличий кадра от отображённого.
+
+private:
+
+};
+
+#endif
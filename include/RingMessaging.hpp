@@ -0,0 +1,230 @@
+#ifndef RING_MESSAGING
+#define RING_MESSAGING
+
+#include <cstddef>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <iterator>
+
+#include "MessagingStatistics.hpp"
+
+//////////////// RingMessaging /////////////////
+// Интерфейс для межпоточного общения путём сообщений.
+// Реализация на ограниченном кольцевом буфере без блокировок для одного отправителя и одного получателя.
+// Получатель при отсутствии сообщений некоторое время крутится в ожидании и только затем засыпает.
+template<typename T, size_t Capacity = 256>
+class RingMessaging
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Ёмкость кольцевого буфера должна быть степенью двойки.");
+
+public:
+    RingMessaging() : messages(Capacity)
+    {
+        #ifdef MESSAGING_STATISTICS
+        send_times.resize(Capacity);
+        #endif
+    }
+    RingMessaging(const RingMessaging& messaging) : messages(Capacity)
+    {
+        #ifdef MESSAGING_STATISTICS
+        send_times.resize(Capacity);
+        #endif
+        copy(messaging);
+    }
+    ~RingMessaging()
+    {
+        // ...
+    }
+
+    static constexpr size_t capacity() { return Capacity; } // Число сообщений, вмещаемых без ожидания получателя.
+
+    void send(const T& message) // Отправить сообщение.
+    {
+        size_t tail = tail_index.load(std::memory_order_relaxed);
+
+        // Ожидание освобождения места в заполненном буфере.
+        for (size_t attempt = 0; tail - head_index.load(std::memory_order_acquire) >= Capacity; ++attempt)
+        {
+            #ifdef MESSAGING_STATISTICS
+            if (attempt == 0) { statistics_messages.contention(); }
+            #endif
+            pause(attempt);
+        }
+
+        messages[tail & mask] = message;
+        #ifdef MESSAGING_STATISTICS
+        send_times[tail & mask] = MessagingStatistics::now();
+        statistics_messages.sent(1, tail + 1 - head_index.load(std::memory_order_relaxed));
+        #endif
+        tail_index.store(tail + 1, std::memory_order_seq_cst);
+        wake();
+    }
+    template<typename Iterator>
+    void send_batch(Iterator begin, Iterator end) // Отправить набор сообщений с одной публикацией и одним пробуждением.
+    {
+        if (begin == end) { return; }
+        size_t tail = tail_index.load(std::memory_order_relaxed);
+        for (Iterator iterator = begin; iterator != end; ++iterator)
+        {
+            // При заполнении буфера уже записанные сообщения публикуются, чтобы получатель мог их забрать.
+            if (tail - head_index.load(std::memory_order_acquire) >= Capacity)
+            {
+                #ifdef MESSAGING_STATISTICS
+                statistics_messages.contention();
+                #endif
+                tail_index.store(tail, std::memory_order_seq_cst);
+                wake();
+                for (size_t attempt = 0; tail - head_index.load(std::memory_order_acquire) >= Capacity; ++attempt)
+                { pause(attempt); }
+            }
+            messages[tail & mask] = *iterator;
+            #ifdef MESSAGING_STATISTICS
+            send_times[tail & mask] = MessagingStatistics::now();
+            #endif
+            ++tail;
+        }
+        #ifdef MESSAGING_STATISTICS
+        statistics_messages.sent(std::distance(begin, end), tail - head_index.load(std::memory_order_relaxed));
+        #endif
+        tail_index.store(tail, std::memory_order_seq_cst);
+        wake();
+    }
+    T receive() // Принять сообщение.
+    {
+        T message;
+        for (size_t attempt = 0; !try_receive(message); ++attempt)
+        {
+            // Кратковременное активное ожидание, затем засыпание до прихода сообщения.
+            if (attempt < spin_limit) { pause(attempt); }
+            else { park(); }
+        }
+        return message;
+    }
+    size_t receive_all(std::vector<T>& received) // Дождаться сообщений и забрать все накопившиеся (дописываются в конец received).
+    {
+        size_t head = head_index.load(std::memory_order_relaxed);
+        size_t tail = tail_index.load(std::memory_order_acquire);
+        for (size_t attempt = 0; head == tail; ++attempt)
+        {
+            if (attempt < spin_limit) { pause(attempt); }
+            else { park(); }
+            tail = tail_index.load(std::memory_order_acquire);
+        }
+        return take(head, tail, received);
+    }
+    size_t try_receive_all(std::vector<T>& received) // Забрать все накопившиеся сообщения без ожидания (дописываются в конец received).
+    {
+        size_t head = head_index.load(std::memory_order_relaxed);
+        size_t tail = tail_index.load(std::memory_order_acquire);
+        if (head == tail) { return 0; }
+        return take(head, tail, received);
+    }
+    bool try_receive(T& message) // Попытка принять сообщение.
+    {
+        size_t head = head_index.load(std::memory_order_relaxed);
+        if (head == tail_index.load(std::memory_order_acquire)) { return false; }
+
+        // Получение верхнего сообщения.
+        message = messages[head & mask];
+        #ifdef MESSAGING_STATISTICS
+        statistics_messages.received(send_times[head & mask], MessagingStatistics::now());
+        #endif
+        head_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    #ifdef MESSAGING_STATISTICS
+    MessagingStatistics::Counters statistics() const { return statistics_messages.snapshot(); } // Счётчики почтового ящика.
+    #endif
+
+    // Копирование допустимо только при отсутствии работающих с буферами потоков.
+    RingMessaging& operator=(const RingMessaging& messaging)
+    {
+        copy(messaging);
+        return *this;
+    }
+
+protected:
+    static constexpr size_t mask = Capacity - 1;
+    static constexpr size_t spin_limit = 128; // Число попыток до засыпания получателя.
+
+    // Сообщения.
+    std::vector<T> messages;
+    alignas(64) std::atomic<size_t> head_index{0}; // Изменяется только получателем.
+    alignas(64) std::atomic<size_t> tail_index{0}; // Изменяется только отправителем.
+
+    // Засыпание получателя.
+    alignas(64) std::atomic<bool> is_sleeping{false};
+    std::mutex mutex_sleeping;
+    std::condition_variable condition_sleeping;
+
+    #ifdef MESSAGING_STATISTICS
+    std::vector<uint64_t> send_times; // Моменты отправки сообщений в ячейках буфера.
+    MessagingStatistics statistics_messages;
+    #endif
+
+    // Извлечение сообщений с head по tail.
+    size_t take(size_t head, size_t tail, std::vector<T>& received)
+    {
+        #ifdef MESSAGING_STATISTICS
+        uint64_t received_time = MessagingStatistics::now();
+        for (size_t index = head; index != tail; ++index)
+        { statistics_messages.received(send_times[index & mask], received_time); }
+        #endif
+        for (size_t index = head; index != tail; ++index)
+        { received.push_back(messages[index & mask]); }
+        head_index.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+    // Кратковременное ожидание: сначала холостой цикл, затем уступка процессора.
+    static void pause(size_t attempt)
+    {
+        if (attempt < 32) { std::atomic_signal_fence(std::memory_order_seq_cst); }
+        else { std::this_thread::yield(); }
+    }
+    // Засыпание получателя до появления сообщений.
+    void park()
+    {
+        std::unique_lock<std::mutex> lock(mutex_sleeping);
+        is_sleeping.store(true, std::memory_order_seq_cst);
+        while (head_index.load(std::memory_order_relaxed) == tail_index.load(std::memory_order_seq_cst))
+        {
+            condition_sleeping.wait(lock);
+            #ifdef MESSAGING_STATISTICS
+            if (head_index.load(std::memory_order_relaxed) == tail_index.load(std::memory_order_seq_cst)) { statistics_messages.empty_wakeup(); }
+            #endif
+        }
+        is_sleeping.store(false, std::memory_order_relaxed);
+    }
+    // Пробуждение получателя, если он заснул.
+    void wake()
+    {
+        if (is_sleeping.load(std::memory_order_seq_cst))
+        {
+            std::lock_guard<std::mutex> lock(mutex_sleeping);
+            condition_sleeping.notify_one();
+        }
+    }
+    void copy(const RingMessaging& messaging)
+    {
+        size_t head = messaging.head_index.load();
+        size_t tail = messaging.tail_index.load();
+        for (size_t index = head; index != tail; ++index)
+        {
+            messages[(index - head) & mask] = messaging.messages[index & mask];
+            #ifdef MESSAGING_STATISTICS
+            send_times[(index - head) & mask] = messaging.send_times[index & mask];
+            #endif
+        }
+        head_index.store(0);
+        tail_index.store(tail - head);
+    }
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SWEEP
+#define SWEEP
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Controller.hpp"
+
+////////////////     Sweep     /////////////////
+// Перебор параметров модели: одна и та же трасса прогоняется для всех сочетаний заданных значений
+// числа лифтов и параметров лифтов. Независимые прогоны (каждый со своим контроллером) выполняются
+// одновременно на нескольких потоках; трасса общая и только читается. Прогоны могут ответвляться
+// от общей контрольной точки: тогда каждый продолжает её со своими параметрами лифтов.
+class Sweep
+{
+public:
+    struct Parameters
+    {
+        uint64_t elevators_number = 0;
+        Elevator::Settings settings = {};
+    };
+
+    struct Result
+    {
+        Parameters parameters;
+        tick_t ticks = 0;
+        uint64_t delivered = 0;
+        double wait_mean = 0.0;
+        uint64_t wait_p90 = 0;
+        uint64_t wait_p99 = 0;
+        uint64_t wait_max = 0;
+        double ride_mean = 0.0;
+        uint64_t ride_p90 = 0;
+        double throughput_mean = 0.0;
+        double busy = 0.0; // Доля времени парка вне ожидания.
+        double wall_seconds = 0.0;
+        bool is_restored = true; // Удалось ли восстановить контрольную точку.
+    };
+
+    Sweep(size_t init_floors_number, const Parameters& init_base, const Controller::Options& init_options);
+
+    // Значения параметра: "имя=a,b,c" или "имя=от:до[:шаг]". Имена: elevators, capacity, stage, open, idle, close, in, out.
+    bool vary(const std::string& specification, std::ostream& errors = std::cerr);
+    size_t size() const; // Число прогонов (сочетаний значений).
+
+    void fork(const Checkpoint* init_origin); // Ответвление прогонов от контрольной точки (nullptr - прогоны с начала).
+    // Выполнение всех прогонов на jobs потоках (0 - по числу ядер); false, если контрольную точку не удалось восстановить.
+    bool run(const std::vector<Person>& persons, size_t jobs = 0, std::ostream& errors = std::cerr);
+    void print(std::ostream& output) const; // Вывод таблицы результатов (значения через табуляцию).
+
+    const std::vector<Result>& results() const { return _results; }
+
+protected:
+    static const std::vector<std::string> names; // Имена параметров в порядке столбцов таблицы.
+
+    size_t floors_number;
+    Parameters base;
+    Controller::Options options;
+    const Checkpoint* origin = nullptr;
+    std::vector<std::vector<uint64_t>> values; // Перебираемые значения каждого параметра (пусто - базовое значение).
+    std::vector<Result> _results;
+
+    Parameters parameters(size_t run) const; // Сочетание значений для прогона с заданным номером.
+    Result execute(const std::vector<Person>& persons, const Parameters& run_parameters) const; // Один прогон.
+    static uint64_t& field(Parameters& parameters, size_t parameter); // Ссылка на параметр по номеру.
+
+private:
+
+};
+
+#endif
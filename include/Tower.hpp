@@ -0,0 +1,78 @@
+#ifndef TOWER
+#define TOWER
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Barrier.hpp"
+#include "Controller.hpp"
+
+////////////////     Tower     /////////////////
+// Многозонная модель здания: этажи разбиты на зоны, каждая обслуживается своей группой лифтов и моделируется
+// отдельным контроллером в собственном потоке. Соседние зоны имеют общий этаж пересадки (sky lobby);
+// люди, чья поездка пересекает зоны, выходят на этаже пересадки и передаются следующей зоне.
+// Зоны продвигают время эпохами одинаковой длины и синхронизируются барьером в конце каждой эпохи;
+// вышедшие на пересадку за эпоху люди поступают в очереди следующих зон в начале следующей эпохи.
+class Tower
+{
+public:
+    struct Zone
+    {
+        ssize_t lowest;          // Нижний этаж зоны.
+        ssize_t highest;         // Верхний этаж зоны.
+        size_t elevators_number; // Число лифтов группы.
+    };
+
+    // Разбор зон: "нижний-верхний:лифты,..." - зоны подряд снизу вверх, соседние зоны имеют общий этаж.
+    static bool parse(const std::string& specification, size_t floors_number, std::vector<Zone>& zones, std::ostream& errors = std::cerr);
+
+    Tower(const std::vector<Zone>& init_zones, const Elevator::Settings& settings, const Controller::Options& options, tick_t init_epoch);
+    ~Tower();
+
+    void run(Arrivals& arrivals); // Пакетный прогон по источнику прибытий до полной развозки людей.
+    void print_summary(std::ostream& output); // Вывод машиночитаемой сводки по прогону.
+
+protected:
+    static constexpr size_t rejected = SIZE_MAX; // Зона для людей с некорректными этажами.
+
+    // Зона и её контроллер.
+    struct Shard
+    {
+        Zone zone;
+        std::unique_ptr<Controller> controller;
+        std::vector<Person> pending;  // Люди, поступающие в зону на текущей эпохе (прибытия и пересадки), в порядке времени.
+        std::vector<Person> handoffs; // Люди, вышедшие на пересадку на текущей эпохе (в номерах этажей здания).
+        uint64_t transfers = 0;       // Число принятых пересадок.
+    };
+
+    std::vector<Zone> zones;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::thread> threads;
+    Barrier barrier;
+
+    // Эпохи. Поля изменяются только управляющим потоком между барьерами.
+    tick_t epoch;            // Длина эпохи.
+    tick_t epoch_end = 0;    // Конец текущей эпохи.
+    bool is_running = true;  // Продолжать ли работу потокам зон.
+    bool is_draining = false; // Прибытия закончились: зоны досчитываются только до развозки людей.
+
+    // Статистика прогона.
+    uint64_t epochs_count = 0;
+    uint64_t arrived_count = 0;
+    uint64_t rejected_count = 0;
+    uint64_t transfers_count = 0;
+    std::chrono::steady_clock::duration wall_time = std::chrono::steady_clock::duration::zero();
+
+    size_t route(Person& person) const; // Зона очередного участка поездки (person получает пункт назначения участка).
+    void work(size_t shard); // Цикл потока зоны.
+    void stop(); // Остановка потоков зон.
+
+private:
+
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cinttypes>
+#include <iostream>
+#include <vector>
+
+////////////////     Trace     /////////////////
+// Запись интервалов выполнения по потокам с выводом в формате Chrome Trace (chrome://tracing, Perfetto).
+// Включается при сборке с TRACE; иначе макросы TRACE_SCOPE и TRACE_DUMP раскрываются в пустоту.
+// Каждый поток пишет в собственный буфер без синхронизации; буферы переживают завершение потоков.
+#ifdef TRACE
+
+class Trace
+{
+public:
+    static constexpr size_t buffer_limit = 1 << 20; // Наибольшее число событий в буфере одного потока.
+
+    struct Event
+    {
+        const char* name; // Имя интервала (строковый литерал).
+        uint64_t begin;   // Начало, нс.
+        uint64_t end;     // Конец, нс.
+    };
+
+    // Запись интервала от создания до разрушения объекта.
+    class Scope
+    {
+    public:
+        Scope(const char* init_name) : name(init_name), begin(Trace::now()) { }
+        ~Scope() { Trace::record(name, begin, Trace::now()); }
+
+    protected:
+        const char* name;
+        uint64_t begin;
+    };
+
+    static uint64_t now(); // Время от начала работы программы, нс.
+    static void record(const char* name, uint64_t begin, uint64_t end); // Запись интервала в буфер текущего потока.
+    static void dump(std::ostream& output); // Вывод всех буферов в формате Chrome Trace JSON (при остановленных потоках).
+
+    struct Buffer
+    {
+        size_t thread;             // Номер потока.
+        std::vector<Event> events;
+        uint64_t dropped = 0;      // Число событий, не поместившихся в буфер.
+    };
+
+protected:
+    static Buffer& buffer(); // Буфер текущего потока (создаётся при первом обращении).
+
+private:
+
+};
+
+#define TRACE_CONCAT_(left, right) left##right
+#define TRACE_CONCAT(left, right) TRACE_CONCAT_(left, right)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(__trace_scope_, __LINE__)(name)
+#define TRACE_DUMP(output) Trace::dump(output)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_DUMP(output)
+
+#endif
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TRAFFIC_GENERATOR
+#define TRAFFIC_GENERATOR
+
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arrivals.hpp"
+
+//////////////// TrafficGenerator /////////////////
+// Синтетический поток прибытий: неоднородный пуассоновский процесс с кусочно-линейной интенсивностью
+// и весами этажей прибытия и назначения. Поток детерминирован при заданном зерне.
+class TrafficGenerator : public Arrivals
+{
+public:
+    struct Profile
+    {
+        std::vector<std::pair<tick_t, double>> rates; // Точки интенсивности (время, людей за тик); между точками - линейная интерполяция.
+        std::vector<double> origins;                  // Веса этажей прибытия.
+        std::vector<double> destinations;             // Веса этажей назначения.
+        double lobby_origin = 0.0;                    // Доля людей, прибывающих на первый этаж (вестибюль).
+        double lobby_destination = 0.0;               // Доля людей, едущих на первый этаж.
+    };
+
+    // Готовые профили: uniform (равномерный межэтажный), up-peak (утренний подъём из вестибюля),
+    // down-peak (вечерний спуск в вестибюль), lunch (обеденный двусторонний поток).
+    static bool preset(const std::string& name, size_t floors_number, double rate, tick_t duration, Profile& profile);
+
+    TrafficGenerator(const Profile& init_profile, tick_t init_duration, uint64_t seed, uint64_t init_limit = 0);
+
+    bool next(Person& person) override;
+
+protected:
+    Profile profile;
+    tick_t duration;   // Время окончания прибытий.
+    uint64_t limit;    // Наибольшее число людей (0 - без ограничения).
+    uint64_t generated = 0;
+
+    std::mt19937_64 generator;
+    double time = 0.0;      // Время последнего прибытия (непрерывное).
+    double rate_max = 0.0;  // Наибольшая интенсивность (для прореживания).
+    std::discrete_distribution<size_t> origins;
+    std::discrete_distribution<size_t> destinations;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+    double rate(double at) const; // Интенсивность в момент времени.
+    size_t floors() const; // Число этажей.
+
+private:
+
+};
+
+#endif
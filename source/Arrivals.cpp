@@ -0,0 +1,44 @@
+#include "Arrivals.hpp"
+
+//////////////// TraceArrivals /////////////////
+// Прибытия из текстовой трассы.
+// PUBLIC:
+TraceArrivals::TraceArrivals(std::istream& init_input) : input(init_input)
+{
+    // ...
+}
+
+bool TraceArrivals::next(Person& person)
+{
+    person = {0, 0, 0};
+    return static_cast<bool>(input >> person.timestamp >> person.origin >> person.destination);
+}
+
+// PROTECTED:
+
+// PRIVATE:
+
+//////////////// ReplayArrivals /////////////////
+// Прибытия из трассы в памяти.
+// PUBLIC:
+ReplayArrivals::ReplayArrivals(const std::vector<Person>& init_persons) : persons(init_persons)
+{
+    // ...
+}
+
+void ReplayArrivals::load(Arrivals& source, std::vector<Person>& persons)
+{
+    Person person = {0, 0, 0};
+    while (source.next(person)) { persons.push_back(person); }
+}
+
+bool ReplayArrivals::next(Person& person)
+{
+    if (position >= persons.size()) { return false; }
+    person = persons[position++];
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
@@ -0,0 +1,217 @@
+#include "BinaryTrace.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char BinaryTrace::magic[8];
+
+////////////////  BinaryTrace  /////////////////
+// Двоичный формат трассы прибытий.
+// PUBLIC:
+bool BinaryTrace::convert(std::istream& input, const std::string& path, std::ostream& errors)
+{
+    Header header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.record_size = sizeof(Record);
+
+    // Параметры модели.
+    input >> header.floors_number >> header.elevators_number;
+    for (size_t setting = 0; setting < 7; ++setting) { input >> header.settings[setting]; }
+    if (!input)
+    {
+        errors << "Некорректные параметры модели." << std::endl;
+        return false;
+    }
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        errors << "Не удалось создать файл " << path << std::endl;
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Записи разбираются построчно без потоковых операторов и пишутся блоками.
+    std::vector<Record> block;
+    block.reserve(65536);
+    std::vector<uint64_t> index;
+    uint64_t previous = 0;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        const char* begin = line.c_str();
+        char* end = nullptr;
+        uint64_t timestamp = std::strtoull(begin, &end, 10);
+        if (end == begin) { continue; } // Пустая строка.
+        begin = end;
+        long origin = std::strtol(begin, &end, 10);
+        if (end == begin) { errors << "Некорректная строка: " << line << std::endl; return false; }
+        begin = end;
+        long destination = std::strtol(begin, &end, 10);
+        if (end == begin) { errors << "Некорректная строка: " << line << std::endl; return false; }
+        begin = end;
+        uint64_t tags = std::strtoull(begin, &end, 10); // Необязательные метки.
+
+        if ((timestamp > timestamp_mask) || (timestamp < previous))
+        {
+            errors << "Время прибытия вне допустимого диапазона или не упорядочено: " << line << std::endl;
+            return false;
+        }
+        previous = timestamp;
+
+        if (header.records_number % index_stride == 0) { index.push_back(timestamp); }
+        block.push_back({timestamp | ((tags & 0xFFFF) << 48), static_cast<int32_t>(origin), static_cast<int32_t>(destination)});
+        ++header.records_number;
+        if (block.size() == block.capacity())
+        {
+            output.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(Record));
+            block.clear();
+        }
+    }
+    output.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(Record));
+
+    // Индекс и окончательный заголовок.
+    header.index_offset = sizeof(Header) + header.records_number * sizeof(Record);
+    header.index_entries = index.size();
+    output.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint64_t));
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!output)
+    {
+        errors << "Ошибка записи в файл " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+bool BinaryTrace::probe(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    char prefix[sizeof(magic)] = {};
+    input.read(prefix, sizeof(prefix));
+    return input && (std::memcmp(prefix, magic, sizeof(magic)) == 0);
+}
+
+//////////////// BinaryArrivals /////////////////
+// Прибытия из двоичной трассы, отображённой в память.
+// PUBLIC:
+BinaryArrivals::BinaryArrivals()
+{
+    // ...
+}
+BinaryArrivals::~BinaryArrivals()
+{
+    close();
+}
+
+bool BinaryArrivals::open(const std::string& path, std::ostream& errors)
+{
+    close();
+
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        errors << "Не удалось открыть файл " << path << std::endl;
+        return false;
+    }
+    struct stat status;
+    if ((fstat(descriptor, &status) != 0) || (static_cast<size_t>(status.st_size) < sizeof(BinaryTrace::Header)))
+    {
+        ::close(descriptor);
+        errors << "Файл " << path << " не является двоичной трассой." << std::endl;
+        return false;
+    }
+
+    mapping_size = static_cast<size_t>(status.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        errors << "Не удалось отобразить файл " << path << " в память." << std::endl;
+        return false;
+    }
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+
+    // Проверка заголовка и размеров разделов.
+    const BinaryTrace::Header* header = static_cast<const BinaryTrace::Header*>(mapping);
+    bool is_valid = (std::memcmp(header->magic, BinaryTrace::magic, sizeof(BinaryTrace::magic)) == 0) &&
+                    (header->version == BinaryTrace::version) &&
+                    (header->record_size == sizeof(BinaryTrace::Record)) &&
+                    (header->index_offset == sizeof(BinaryTrace::Header) + header->records_number * sizeof(BinaryTrace::Record)) &&
+                    (header->index_offset + header->index_entries * sizeof(uint64_t) <= mapping_size);
+    if (!is_valid)
+    {
+        close();
+        errors << "Файл " << path << " не является двоичной трассой поддерживаемой версии." << std::endl;
+        return false;
+    }
+
+    _header = header;
+    records = reinterpret_cast<const BinaryTrace::Record*>(static_cast<const char*>(mapping) + sizeof(BinaryTrace::Header));
+    index = reinterpret_cast<const uint64_t*>(static_cast<const char*>(mapping) + header->index_offset);
+    position = 0;
+    return true;
+}
+void BinaryArrivals::close()
+{
+    if (mapping) { munmap(mapping, mapping_size); }
+    mapping = nullptr;
+    mapping_size = 0;
+    _header = nullptr;
+    records = nullptr;
+    index = nullptr;
+    position = 0;
+}
+
+Elevator::Settings BinaryArrivals::settings() const
+{
+    const uint64_t* values = _header->settings;
+    Elevator::Settings result;
+    result.capacity = values[0];
+    result.stage = values[1];
+    result.open = values[2];
+    result.idle = values[3];
+    result.close = values[4];
+    result.in = values[5];
+    result.out = values[6];
+    return result;
+}
+void BinaryArrivals::seek(tick_t timestamp)
+{
+    if (!_header) { return; }
+
+    // Поиск по индексу последнего блока, начинающегося раньше заданного времени, затем - внутри блока.
+    uint64_t low = 0;
+    uint64_t high = _header->index_entries;
+    while (low < high)
+    {
+        uint64_t middle = (low + high) / 2;
+        if (index[middle] < timestamp) { low = middle + 1; }
+        else { high = middle; }
+    }
+    position = (low == 0) ? 0 : (low - 1) * BinaryTrace::index_stride;
+    while ((position < _header->records_number) && ((records[position].stamp & BinaryTrace::timestamp_mask) < timestamp))
+    { ++position; }
+}
+
+bool BinaryArrivals::next(Person& person)
+{
+    if (!_header || (position >= _header->records_number)) { return false; }
+
+    const BinaryTrace::Record& record = records[position++];
+    person = {record.stamp & BinaryTrace::timestamp_mask, record.origin, record.destination};
+    last_tags = static_cast<uint16_t>(record.stamp >> 48);
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
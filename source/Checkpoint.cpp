@@ -0,0 +1,60 @@
+#include "Checkpoint.hpp"
+
+#include <fstream>
+#include <iterator>
+
+constexpr char Checkpoint::magic[8];
+
+////////////////   Checkpoint   ////////////////
+// Контрольная точка модели.
+// PUBLIC:
+bool Checkpoint::save(const std::string& path, std::ostream& errors) const
+{
+    // Файл: сигнатура, версия формата, длина данных и сами данные.
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    uint64_t size = data.size();
+    output.write(magic, sizeof(magic));
+    output.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    output.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    output.write(data.data(), data.size());
+    if (!output)
+    {
+        errors << "Ошибка записи в файл " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+bool Checkpoint::load(const std::string& path, std::ostream& errors)
+{
+    std::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        errors << "Не удалось открыть файл " << path << std::endl;
+        return false;
+    }
+
+    char file_magic[sizeof(magic)] = {};
+    uint32_t file_version = 0;
+    uint64_t size = 0;
+    input.read(file_magic, sizeof(file_magic));
+    input.read(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+    input.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!input || (std::memcmp(file_magic, magic, sizeof(magic)) != 0) || (file_version != version))
+    {
+        errors << "Файл " << path << " не является контрольной точкой поддерживаемой версии." << std::endl;
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    if (data.size() != size)
+    {
+        data.clear();
+        errors << "Контрольная точка " << path << " повреждена." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
@@ -1,362 +1,1006 @@
 #include "Controller.hpp"
+#include <algorithm>
 
 #define DEBUG_DELAY
 //#define DEBUG_MESSAGE_DELAY
 //#define DEBUG_INFO
 //#define DEBUG_MAIN_MESSAGES
 
-// Короткая запись временных литералов.
-using namespace std::chrono_literals;
-auto delay = 100ms;
-
 ////////////////   Controller   ////////////////
 // Класс для управления лифтами.
 // PUBLIC:
-Controller::Controller(const size_t floors_number, const size_t elevators_number, const Elevator::Settings& default_settings)
+Controller::Controller(const size_t floors_number, const size_t elevators_number, const Elevator::Settings& default_settings, const Options& init_options) :
+    Controller(floors_number, std::vector<Elevator::Settings>(elevators_number, default_settings), std::vector<FloorMask>(elevators_number, FloorMask(floors_number)), init_options)
+{}
+Controller::Controller(const size_t floors_number, const std::vector<Elevator::Settings>& init_settings, const std::vector<FloorMask>& masks, const Options& init_options)
 {
-    // Инициализация лифтов и запуск потоков.
-    for (size_t elevator = 0; elevator < elevators_number; ++elevator)
-    { elevators.emplace(elevators.end(), default_settings); }
+    options = init_options;
+    elevators_settings = init_settings;
+    const size_t elevators_number = elevators_settings.size();
+
+    // Наборы обслуживаемых этажей: если все лифты обслуживают все этажи, проверки при вызовах и посадке не выполняются.
+    served = masks;
+    served.resize(elevators_number, FloorMask(floors_number));
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator) { is_restricted = is_restricted || !served[elevator].full(); }
+
+    // Инициализация лифтов и запуск потоков (или пула потоков).
+    // Буферы предлагаемых при обмене людей выделяются один раз и не перераспределяются: лифты читают их по указателю.
+    offers = std::vector<std::vector<Person>>(elevators_number);
     for (size_t elevator = 0; elevator < elevators_number; ++elevator)
-    { elevators_threads.emplace(elevators_threads.end(), &Elevator::loop, &(elevators[elevator])); }
+    {
+        elevators.emplace_back(elevators_settings[elevator], floors_number);
+        offers[elevator].resize(elevators_settings[elevator].capacity);
+        elevators[elevator].offers = offers[elevator].data();
+    }
+    #ifdef TRANSPORT_INLINE
+    // При встроенном транспорте лифты обрабатывают сообщения синхронно в потоке контроллера.
+    elevators_outbox = std::vector<std::deque<Elevator::Outcoming>>(elevators_number);
+    #else
+    // Завершение тика лифты отмечают на общем барьере.
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator) { elevators[elevator].countdown = &tick_countdown; }
+    if (options.pooled)
+    {
+        size_t workers = options.workers ? options.workers : std::max<size_t>(1, std::thread::hardware_concurrency());
+        executor.reset(new Executor(workers, elevators_number, [this](size_t elevator) { elevators[elevator].poll(); }));
+    }
+    else
+    {
+        for (size_t elevator = 0; elevator < elevators_number; ++elevator)
+        { elevators_threads.emplace(elevators_threads.end(), &Elevator::loop, &(elevators[elevator])); }
+    }
+    #endif
 
-    // Инициализация очередей.
-    floor_persons = std::vector<std::list<std::pair<Elevator::Direction, Person>>>(floors_number);
+    // Инициализация очередей и зеркал состава пассажиров.
+    floor_queues = PassengerQueues(floors_number);
+    manifests = std::vector<std::vector<Person>>(elevators_number);
+    manifests_versions = std::vector<uint64_t>(elevators_number, 0);
 
     // Инициализация данных, связанных с отрисовкой.
-    elevators_strings = std::vector<std::string>(elevators_number, "[]NW:0");
-    elevators_floors = std::vector<size_t>(elevators_number, 0);
+    elevators_strings = std::vector<std::string>(elevators_number, "[]");
+    elevators_strings_versions = std::vector<uint64_t>(elevators_number, 0);
+    if (options.interactive) { renderer.reset(new Renderer(*options.output, options.frame_rate)); }
 
+    // Инициализация представления состояния лифтов.
+    fleet = ElevatorFleet(elevators_number);
+
+    // Инициализация очередей исходящих сообщений.
+    elevators_pending = std::vector<std::vector<Elevator::Incoming>>(elevators_number);
+
+    // Инициализация показателей.
+    metrics = Metrics(elevators_number, options.window);
+    next_report = options.report_interval;
+
+    // Инициализация диспетчера и групп лифтов.
+    dispatcher = Dispatcher(floors_number, elevators_settings, served);
+    dispatcher.sectorize(options.sectors);
+    groups_called = std::vector<char>(dispatcher.groups(), 0);
 }
 Controller::~Controller()
 {
-    // ...
+    // Остановка потоков лифтов.
+    Elevator::Incoming incoming;
+    incoming.id = id_counter++;
+    incoming.timestamp = timestamp;
+    incoming.code = Elevator::Incoming::Code::Stop;
+    incoming.response = false;
+    broadcast(incoming);
+    flush();
+
+    for (size_t elevator = 0; elevator < elevators_threads.size(); ++elevator)
+    { elevators_threads[elevator].join(); }
+    executor.reset();
+    renderer.reset();
 }
 
-void Controller::loop()
+void Controller::loop(std::istream& input)
 {
     Person next_person = {0, 0, 0};
     while (true)
     {
-        // Печать информации.
-        print_info();
+        // Отрисовка текущего состояния.
+        render(true);
 
         // Чтение данных о следующем человеке.
-        std::cout << "Следующий человек: ";
-        std::cin >> next_person.timestamp >> next_person.origin >> next_person.destination;
+        if (renderer) { renderer->prompt("Следующий человек: "); }
+        if (!(input >> next_person.timestamp >> next_person.origin >> next_person.destination))
+        { break; }
 
-        // Если время прихода следующего человека ещё не пришло, обрабатываем тик времени.
-        while (next_person.timestamp > timestamp)
+        // Если время прихода следующего человека ещё не пришло, обрабатываем тики времени.
+        advance(next_person.timestamp);
+
+        // Постановка человека в очередь.
+        enqueue(next_person);
+    }
+}
+bool Controller::run(std::istream& input)
+{
+    TraceArrivals arrivals(input);
+    return run(arrivals);
+}
+bool Controller::run(Arrivals& arrivals)
+{
+    TRACE_SCOPE("Controller::run");
+    auto begin = std::chrono::steady_clock::now();
+
+    // Пропуск прибытий, уже поступивших до контрольной точки.
+    Person next_person = {0, 0, 0};
+    for (uint64_t skipped = 0; (skipped < arrived_count) && arrivals.next(next_person); ++skipped);
+
+    // Получение прибытий до их окончания.
+    bool is_running = true;
+    while (is_running && arrivals.next(next_person))
+    {
+        is_running = advance(next_person.timestamp);
+        if (is_running) { enqueue(next_person); }
+    }
+
+    // Досчёт модели до тех пор, пока все люди не будут доставлены.
+    if (is_running)
+    {
+        settle(options.pause_at);
+        is_running = is_finished();
+    }
+
+    wall_time = std::chrono::steady_clock::now() - begin;
+    return is_running;
+}
+void Controller::checkpoint(Checkpoint& checkpoint) const
+{
+    // Параметры модели.
+    checkpoint.write<uint64_t>(floor_queues.floors());
+    checkpoint.write(elevators_settings);
+
+    // Время и статистика прогона.
+    checkpoint.write(id_counter);
+    checkpoint.write(timestamp);
+    checkpoint.write(steps_count);
+    checkpoint.write(arrived_count);
+    checkpoint.write(rejected_count);
+    checkpoint.write(delivered_count);
+    checkpoint.write(posted_count);
+    checkpoint.write(reassigned_count);
+    checkpoint.write(next_report);
+    metrics.store(checkpoint);
+
+    // Лифты, их представление на стороне контроллера и неотправленные им сообщения.
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator) { elevators[elevator].store(checkpoint); }
+    fleet.store(checkpoint);
+    dispatcher.store(checkpoint);
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator) { checkpoint.write(elevators_pending[elevator]); }
+
+    // Люди.
+    floor_queues.store(checkpoint);
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator) { checkpoint.write(manifests[elevator]); }
+}
+bool Controller::restore(const Checkpoint& checkpoint)
+{
+    Checkpoint::Reader reader(checkpoint);
+    size_t floors_number = 0;
+    std::vector<Elevator::Settings> checkpoint_settings;
+    if (!read_header(reader, floors_number, checkpoint_settings) ||
+        (floors_number != floor_queues.floors()) || (checkpoint_settings.size() != elevators.size()))
+    { return false; }
+
+    bool is_read = reader.read(id_counter) && reader.read(timestamp) && reader.read(steps_count) &&
+                   reader.read(arrived_count) && reader.read(rejected_count) && reader.read(delivered_count) &&
+                   reader.read(posted_count) && reader.read(reassigned_count) && reader.read(next_report) &&
+                   metrics.restore(reader);
+    for (size_t elevator = 0; is_read && (elevator < elevators.size()); ++elevator) { is_read = elevators[elevator].restore(reader); }
+    is_read = is_read && fleet.restore(reader) && dispatcher.restore(reader);
+    for (size_t elevator = 0; is_read && (elevator < elevators.size()); ++elevator) { is_read = reader.read(elevators_pending[elevator]); }
+    is_read = is_read && floor_queues.restore(reader);
+    for (size_t elevator = 0; is_read && (elevator < elevators.size()); ++elevator) { is_read = reader.read(manifests[elevator]); }
+    if (!is_read || !reader.finished() || (floor_queues.floors() != floors_number)) { return false; }
+
+    // Строки отрисовки перестраиваются по восстановленным зеркалам.
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator) { ++manifests_versions[elevator]; }
+    return true;
+}
+bool Controller::describe(const Checkpoint& checkpoint, size_t& floors_number, size_t& elevators_number)
+{
+    Checkpoint::Reader reader(checkpoint);
+    std::vector<Elevator::Settings> settings;
+    if (!read_header(reader, floors_number, settings)) { return false; }
+    elevators_number = settings.size();
+    return true;
+}
+
+void Controller::print_summary(std::ostream& output)
+{
+    double seconds = get_wall_seconds();
+    output << "{"
+           << "\"floors\": " << floor_queues.floors() << ", "
+           << "\"elevators\": " << elevators.size() << ", "
+           << "\"ticks\": " << timestamp << ", "
+           << "\"steps\": " << steps_count << ", "
+           << "\"arrived\": " << arrived_count << ", "
+           << "\"rejected\": " << rejected_count << ", "
+           << "\"delivered\": " << delivered_count << ", "
+           << "\"messages\": " << id_counter << ", "
+           << "\"posted\": " << posted_count << ", "
+           << "\"reassigned\": " << reassigned_count << ", "
+           << "\"wall_seconds\": " << seconds << ", "
+           << "\"ticks_per_second\": " << (seconds > 0.0 ? timestamp / seconds : 0.0) << ", "
+           << "\"metrics\": ";
+    metrics.print(output, timestamp);
+
+    // Счётчики почтовых ящиков, просуммированные по всем лифтам.
+    #if defined(MESSAGING_STATISTICS) && !defined(TRANSPORT_INLINE)
+    MessagingStatistics::Counters inbox;
+    MessagingStatistics::Counters outbox;
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+    {
+        inbox += elevators[elevator].inbox.statistics();
+        outbox += elevators[elevator].outbox.statistics();
+    }
+    output << ", \"messaging\": {\"inbox\": ";
+    inbox.print(output);
+    output << ", \"outbox\": ";
+    outbox.print(output);
+    output << "}";
+    #endif
+    output << "}" << std::endl;
+}
+
+bool Controller::advance(tick_t until)
+{
+    while (until > timestamp)
+    {
+        if (timestamp >= options.pause_at) { return false; }
+
+        // Отрисовка, если поток отрисовки ожидает кадр.
+        render();
+        tick(next_delta(std::min(until, options.pause_at)));
+    }
+    return true;
+}
+void Controller::settle(tick_t until)
+{
+    while (!is_finished() && (timestamp < until))
+    { tick(next_delta(until)); }
+}
+void Controller::enqueue(const Person& person)
+{
+    TRACE_SCOPE("Controller::enqueue");
+    ++arrived_count;
+
+    // Люди с некорректными этажами или без необходимости ехать отбрасываются.
+    if ((person.origin < 0) || (static_cast<size_t>(person.origin) >= floor_queues.floors()) ||
+        (person.destination < 0) || (static_cast<size_t>(person.destination) >= floor_queues.floors()) ||
+        (person.origin == person.destination))
+    {
+        ++rejected_count;
+        return;
+    }
+
+    // Отбрасываются и люди, которых не довезёт ни один лифт (при ограниченных наборах этажей).
+    if (is_restricted)
+    {
+        bool is_served = false;
+        for (size_t group = 0; !is_served && (group < dispatcher.groups()); ++group)
+        { is_served = dispatcher.serves(group, person.origin) && dispatcher.serves(group, person.destination) && !dispatcher.members(group).empty(); }
+        if (!is_served)
         {
-            // Печать информации.
-            print_info();
+            ++rejected_count;
+            return;
+        }
+    }
 
-            // Рассылка сообщения о прошедшем времени.
-            {
-                #ifdef DEBUG_DELAY
-                std::this_thread::sleep_for(delay);
-                #endif
-
-                Elevator::Incoming incoming;
-                incoming.id = id_counter++;
-                incoming.timestamp = timestamp;
-                incoming.code = Elevator::Incoming::Code::Tick;
-                incoming.delta_tick = 1;
-                incoming.response = true;
-                timestamp += incoming.delta_tick;
-
-                std::cout << timestamp << std::endl;
-                broadcast(incoming);
-            }
+    // Получение требуемого направления.
+    Elevator::Direction direction = (person.origin > person.destination) ? Elevator::Direction::Downwards : Elevator::Direction::Upwards;
+
+    // Постановка человека в очередь.
+    uint32_t record = floor_queues.push(person, direction);
+
+    // Вызов лифта (при назначении по пунктам назначения - назначение человека лифту).
+    if (options.destination) { destination_call(person.origin, direction, record); }
+    else { hall_call(person.origin, direction, person.destination); }
+}
+bool Controller::is_finished()
+{
+    // Остались ожидающие люди.
+    if (!floor_queues.empty()) { return false; }
+
+    // Остались люди в лифтах или лифты ещё не остановились.
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+    {
+        if (fleet.state[elevator] != Elevator::State::Waiting) { return false; }
+        if (!manifests[elevator].empty()) { return false; }
+    }
+    return true;
+}
 
-            // Обработка событий от лифтов.
-            for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+// PROTECTED:
+tick_t Controller::next_delta(tick_t until)
+{
+    if (!options.event_driven) { return 1; }
+    // Без лифтов ближайшего события нет, и шаг до until исказил бы время прогона.
+    if (fleet.size() == 0) { return 1; }
+
+    // Ближайшее событие: прибытие следующего человека или изменение состояния одного из лифтов
+    // (простаивавшим без вызовов лифтам, получившим вызов, смена состояния назначается на следующий тик).
+    tick_t delta = (until > timestamp) ? until - timestamp : 1;
+    delta = std::min(delta, fleet.next_event());
+
+    return ((delta == 0) || (delta == Elevator::never)) ? 1 : delta;
+}
+void Controller::tick(tick_t delta)
+{
+    TRACE_SCOPE("Controller::tick");
+
+    // Рассылка сообщения о прошедшем времени.
+    {
+        #ifdef DEBUG_DELAY
+        if (options.interactive) { std::this_thread::sleep_for(options.delay); }
+        #endif
+        TRACE_SCOPE("Controller::send_ticks");
+
+        Elevator::Incoming incoming;
+        incoming.id = id_counter++;
+        incoming.timestamp = timestamp;
+        incoming.code = Elevator::Incoming::Code::Tick;
+        incoming.response = true;
+        timestamp += delta;
+        ++steps_count;
+
+        // Тик получают только лифты, у которых на этом шаге меняется состояние; накопленное время передаётся им целиком
+        // (кроме лифтов в режиме ожидания, у которых прогресс не накапливается).
+        fleet.advance(delta, elevators_due);
+        for (size_t index = 0; index < elevators_due.size(); ++index)
+        {
+            const size_t elevator = elevators_due[index];
+            incoming.delta_tick = (fleet.state[elevator] == Elevator::State::Waiting) ? delta : fleet.elapsed(elevator, timestamp);
+            post(elevator, incoming);
+        }
+
+        // Отправляются только сообщения лифтам, получившим тик: их обработку контроллер дожидается на барьере.
+        // Сообщения остальным лифтам (отмены вызовов) не меняют их поведения до ближайшего тика и ждут его в очереди,
+        // чтобы к концу шага все потоки лифтов простаивали и контрольная точка снимала согласованное состояние.
+        tick_countdown.reset(elevators_due.size());
+        for (size_t index = 0; index < elevators_due.size(); ++index) { flush(elevators_due[index]); }
+    }
+
+    // Лифты обрабатывают тик параллельно; контроллер просыпается один раз, когда все они отметились на барьере
+    // (при встроенном транспорте тик уже обработан при отправке).
+    #ifndef TRANSPORT_INLINE
+    {
+        TRACE_SCOPE("Controller::wait_tick");
+        tick_countdown.wait();
+    }
+    #endif
+
+    // Обработка событий от лифтов.
+    std::vector<Elevator::Outcoming> outcomings;
+    for (size_t index = 0; index < elevators_due.size(); ++index)
+    {
+        const size_t elevator = elevators_due[index];
+        TRACE_SCOPE("Controller::handle_elevator");
+
+        // Все ответы лифта на тик вплоть до маркера синхронизации уже в его почтовом ящике и забираются разом.
+        outcomings.clear();
+        collect(elevator, outcomings);
+
+        Elevator::Outcoming outcoming;
+        bool in_loop = true;
+        for (size_t index = 0; in_loop && (index < outcomings.size()); ++index)
+        {
+            #ifdef DEBUG_MESSAGE_DELAY
+            std::this_thread::sleep_for(options.delay);
+            #endif
+
+            outcoming = outcomings[index];
+            #ifdef DEBUG_MAIN_MESSAGES
+            std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
+            #endif
+
+            switch (outcoming.code)
             {
-                Elevator::Outcoming outcoming;
-                bool in_loop = true;
-                //while (elevators[i].outbox.try_receive(outcoming))
-                while (in_loop)
+                case Elevator::Outcoming::Code::Response:
+                {
+                    in_loop = false;
+                    break;
+                }
+                case Elevator::Outcoming::Code::Success: { break; } // Заглушки.
+                case Elevator::Outcoming::Code::Denied:  { break; }
+                case Elevator::Outcoming::Code::Arrived:
                 {
-                    #ifdef DEBUG_MESSAGE_DELAY
-                    std::this_thread::sleep_for(delay);
+                    #ifdef DEBUG_INFO
+                    std::cout << "Лифт " << elevator << " прибыл на этаж " << outcoming.floor << std::endl;
                     #endif
 
-                    outcoming = elevators[elevator].outbox.receive();
+                    // Остановка учитывается вместе с числом пассажиров, едущих дальше.
+                    {
+                        const std::vector<Person>& persons = manifests[elevator];
+                        auto alighting = std::equal_range(persons.begin(), persons.end(), Person{0, 0, outcoming.floor},
+                                                          [](const Person& left, const Person& right) { return left.destination < right.destination; });
+                        metrics.stopped(elevator, persons.size() - (alighting.second - alighting.first));
+                    }
+
+                    // Лифт прибыл, отзываются вызовы по его направлению (если оно не нейтральное).
+                    if (outcoming.direction != Elevator::Direction::None) { hall_cancel(elevator, outcoming.floor, outcoming.direction); }
+
+                    // Дополнительно отменяется нейтральный вызов для прибывшего лифта.
+                    Elevator::Incoming incoming;
+                    incoming.id = id_counter++;
+                    incoming.timestamp = timestamp;
+                    incoming.code = Elevator::Incoming::Code::Cancel;
+                    incoming.floor = outcoming.floor;
+                    incoming.direction = Elevator::Direction::None;
+                    incoming.response = false;
+
                     #ifdef DEBUG_MAIN_MESSAGES
-                    std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
+                    std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
+                    #endif
+                    post(elevator, incoming);
+                    break;
+                }
+                case Elevator::Outcoming::Code::Departured:
+                {
+                    #ifdef DEBUG_INFO
+                    std::cout << "Лифт " << elevator << " отправился с этажа " << outcoming.floor << std::endl;
                     #endif
 
-                    switch (outcoming.code)
+                    // При назначении по пунктам назначения не вошедшие в лифт назначенные ему люди назначаются заново.
+                    if (options.destination)
                     {
-                        case Elevator::Outcoming::Code::Response:
-                        {
-                            in_loop = false;
-                            break;
-                        }
-                        case Elevator::Outcoming::Code::Success: { break; } // Заглушки.
-                        case Elevator::Outcoming::Code::Denied:  { break; }
-                        case Elevator::Outcoming::Code::Arrived:
-                        {
-                            #ifdef DEBUG_INFO
-                            std::cout << "Лифт " << elevator << " прибыл на этаж " << outcoming.floor << std::endl;
-                            #endif
-
-                            // Лифт прибыл, отзываются вызовы по его направлению (если оно не нейтральное).
-                            Elevator::Incoming incoming;
-                            incoming.id = id_counter++;
-                            incoming.timestamp = timestamp;
-                            incoming.code = Elevator::Incoming::Code::Cancel;
-                            incoming.floor = outcoming.floor;
-                            incoming.direction = outcoming.direction;
-                            incoming.response = false;
-
-                            if (outcoming.direction != Elevator::Direction::None) { broadcast(incoming); }
-                            incoming.direction = Elevator::Direction::None; // Дополнительно отменяется нейтральный вызов для прибывшего лифта.
-                            incoming.id = id_counter++;
-
-                            #ifdef DEBUG_MAIN_MESSAGES
-                            std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
-                            #endif
-                            elevators[elevator].inbox.send(incoming);
-                            break;
-                        }
-                        case Elevator::Outcoming::Code::Departured:
-                        {
-                            #ifdef DEBUG_INFO
-                            std::cout << "Лифт " << elevator << " отправился с этажа " << outcoming.floor << std::endl;
-                            #endif
+                        depart(elevator, outcoming.floor);
+                        break;
+                    }
+
+                    // При отбытии лифта необходимо заново сделать вызов, если остались люди.
+                    for (Elevator::Direction direction : { Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+                    {
+                        if (!floor_queues.empty(outcoming.floor, direction)) { hall_call(outcoming.floor, direction); }
+                    }
+                    break;
+                }
+                case Elevator::Outcoming::Code::Idling:
+                {
+                    #ifdef DEBUG_INFO
+                    std::cout << "Лифт " << elevator << " ожидает на этаже " << outcoming.floor << std::endl;
+                    #endif
+
+                    // Маркер синхронизации следует сразу за этим сообщением и пропускается.
+                    in_loop = false;
 
-                            // При отбытии лифта необходимо заново сделать вызов, если остались люди.
-                            std::set<Elevator::Direction> need_recalling;
+                    // Выход и посадка всех людей разом.
+                    if (options.bulk)
+                    {
+                        outcoming = exchange(elevator, outcoming.floor, outcoming.direction);
+                        break;
+                    }
 
-                            // Проход по очереди людей и получение множества необходимых направлений.
-                            for (auto iterator = floor_persons[outcoming.floor].begin(); iterator != floor_persons[outcoming.floor].end(); ++iterator)
-                            { need_recalling.insert(iterator->first); }
+                    // Из лифта можно извлечь человека или посадить внутрь.
+                    size_t floor = outcoming.floor;
 
-                            // Проход по требуемым направлениям и вызов лифтов.
-                            for (auto iterator = need_recalling.begin(); iterator != need_recalling.end(); ++iterator)
+                    // Так как извлечение людей приоритетнее, отправляется сообщение на извлечение очередного человека, для которого этот этаж - пункт назначения.
+                    Elevator::Incoming incoming;
+                    incoming.id = id_counter++;
+                    incoming.timestamp = timestamp;
+                    incoming.code = Elevator::Incoming::Code::Disembark;
+                    incoming.response = false;
+
+                    #ifdef DEBUG_MAIN_MESSAGES
+                    std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
+                    #endif
+                    post(elevator, incoming);
+                    flush(elevator);
+                    outcoming = receive(elevator);
+                    #ifdef DEBUG_MAIN_MESSAGES
+                    std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
+                    #endif
+
+                    switch (outcoming.code)
+                    {
+                        // Нет ни одного человека, которому требуется выйти на этом этаже.
+                        case Elevator::Outcoming::Code::Empty:
+                        {
+                            // В случае, если все требуемые люди извлечены, производится посадка первого человека из очереди по направлению лифта.
+                            // При ограниченных наборах этажей или назначении по пунктам назначения садится первый человек, которого должен везти этот лифт.
+                            const Elevator::Direction direction = outcoming.direction;
+                            const bool is_selective = is_restricted || options.destination;
+                            uint32_t record = PassengerQueues::end;
+                            uint32_t previous = PassengerQueues::end;
+                            if ((direction != Elevator::Direction::None) && (!is_restricted || served[elevator].contains(floor)))
+                            {
+                                record = floor_queues.first(floor, direction);
+                                while (is_selective && (record != PassengerQueues::end) && !boards(elevator, record))
+                                {
+                                    previous = record;
+                                    record = floor_queues.next(record);
+                                }
+                            }
+                            if (record != PassengerQueues::end)
                             {
-                                Elevator::Incoming incoming;
+                                Person person = floor_queues.person(floor, record);
+
+                                // Отправляется сообщение о посадке человека.
                                 incoming.id = id_counter++;
-                                incoming.timestamp = timestamp;
-                                incoming.code = Elevator::Incoming::Code::Call;
-                                incoming.floor = outcoming.floor;
-                                incoming.direction = *iterator;
+                                incoming.code = Elevator::Incoming::Code::Embark;
+                                incoming.person = person;
                                 incoming.response = false;
 
-                                broadcast(incoming);
-                            }
-                            break;
-                        }
-                        case Elevator::Outcoming::Code::Idling:
-                        {
-                            #ifdef DEBUG_INFO
-                            std::cout << "Лифт " << elevator << " ожидает на этаже " << outcoming.floor << std::endl;
-                            #endif
-
-                            // Пропуск маркера синхронизации.
-                            elevators[elevator].outbox.receive();
-                            in_loop = false;
-
-                            // Из лифта можно извлечь человека или посадить внутрь.
-                            size_t floor = outcoming.floor;
-
-                            // Так как извлечение людей приоритетнее, отправляется сообщение на извлечение очередного человека, для которого этот этаж - пункт назначения.
-                            Elevator::Incoming incoming;
-                            incoming.id = id_counter++;
-                            incoming.timestamp = timestamp;
-                            incoming.code = Elevator::Incoming::Code::Disembark;
-                            incoming.response = false;
-
-                            #ifdef DEBUG_MAIN_MESSAGES
-                            std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
-                            #endif
-                            elevators[elevator].inbox.send(incoming);
-                            outcoming = elevators[elevator].outbox.receive();
-                            #ifdef DEBUG_MAIN_MESSAGES
-                            std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
-                            #endif
-
-                            switch (outcoming.code)
-                            {
-                                // Нет ни одного человека, которому требуется выйти на этом этаже.
-                                case Elevator::Outcoming::Code::Empty:
+                                #ifdef DEBUG_MAIN_MESSAGES
+                                std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
+                                #endif
+                                post(elevator, incoming);
+                                flush(elevator);
+                                outcoming = receive(elevator);
+                                #ifdef DEBUG_MAIN_MESSAGES
+                                std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
+                                #endif
+
+                                switch (outcoming.code)
                                 {
-                                    // В случае, если все требуемые люди извлечены, производится посадка.
-                                    for (auto iterator = floor_persons[floor].begin(); iterator != floor_persons[floor].end(); ++iterator)
+                                    // Место есть.
+                                    case Elevator::Outcoming::Code::Success:
                                     {
-                                        // При проходе по очереди пассажиров находится первый, которому нужно ехать в том же направлении, что и лифту.
-                                        if (iterator->first == outcoming.direction)
-                                        {
-                                            // Отправляется сообщение о посадке человека.
-                                            incoming.id = id_counter++;
-                                            incoming.code = Elevator::Incoming::Code::Embark;
-                                            incoming.person = iterator->second;
-                                            incoming.response = false;
-
-                                            #ifdef DEBUG_MAIN_MESSAGES
-                                            std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl;
-                                            #endif
-                                            elevators[elevator].inbox.send(incoming);
-                                            outcoming = elevators[elevator].outbox.receive();
-                                            #ifdef DEBUG_MAIN_MESSAGES
-                                            std::cout << "Получено сообщение с кодом " << static_cast<int>(outcoming.code) << " от лифта под номером " << elevator << std::endl;
-                                            #endif
-
-                                            switch (outcoming.code)
-                                            {
-                                                // Место есть.
-                                                case Elevator::Outcoming::Code::Success:
-                                                {
-                                                    // Пункт назначения добавляется в список вызовов.
-                                                    incoming.id = id_counter++;
-                                                    incoming.timestamp = timestamp;
-                                                    incoming.code = Elevator::Incoming::Code::Call;
-                                                    incoming.floor = iterator->second.destination;
-                                                    incoming.direction = Elevator::Direction::None;
-                                                    incoming.response = false;
-
-                                                    #ifdef DEBUG_MAIN_MESSAGES
-                                                    std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl << std::endl;
-                                                    #endif
-                                                    elevators[elevator].inbox.send(incoming);
-
-                                                    // При успешной посадке человека он извлекается из очереди.
-                                                    floor_persons[floor].erase(iterator);
-                                                    break;
-                                                }
-                                                // Мест нет.
-                                                case Elevator::Outcoming::Code::Full: { break; }
-                                                default: { break; }
-                                            }
-
-                                            // Выход из цикла в любом случае.
-                                            break;
-                                        }
+                                        // Пункт назначения добавляется в список вызовов.
+                                        incoming.id = id_counter++;
+                                        incoming.timestamp = timestamp;
+                                        incoming.code = Elevator::Incoming::Code::Call;
+                                        incoming.floor = person.destination;
+                                        incoming.direction = Elevator::Direction::None;
+                                        incoming.response = false;
+
+                                        #ifdef DEBUG_MAIN_MESSAGES
+                                        std::cout << "Отправка сообщения с кодом " << static_cast<int>(incoming.code) << " лифту под номером " << elevator << std::endl << std::endl;
+                                        #endif
+                                        post(elevator, incoming);
+
+                                        // При успешной посадке человека он извлекается из очереди.
+                                        if (options.destination) { dispatcher.release_person(elevator); }
+                                        floor_queues.erase(floor, direction, record, previous);
+                                        break;
                                     }
-                                    break;
+                                    // Мест нет.
+                                    case Elevator::Outcoming::Code::Full: { break; }
+                                    default: { break; }
                                 }
-                                case Elevator::Outcoming::Code::InProgress: { break; }
-                                default: { break; }
-                            }
-
-                            // Обновление строки, отображающей пассажиров в лифте.
-                            {
-                                std::vector<Person> __persons = elevators[elevator].get_persons();
-                                elevators_strings[elevator] = "[";
-                                for (size_t person = 0; person < __persons.size(); ++person)
-                                { elevators_strings[elevator] += std::to_string(__persons[person].destination) + (person + 1 == __persons.size() ? "" : " "); }
-                                elevators_strings[elevator] += "]";
                             }
                             break;
                         }
-                        case Elevator::Outcoming::Code::InProgress: { break; } // Заглушки.
-                        case Elevator::Outcoming::Code::Empty:      { break; }
-                        case Elevator::Outcoming::Code::Full:       { break; }
+                        // Человек вышел на этом этаже.
+                        case Elevator::Outcoming::Code::Success:
+                        {
+                            ++delivered_count;
+                            break;
+                        }
+                        case Elevator::Outcoming::Code::InProgress: { break; }
+                        default: { break; }
                     }
-                }
 
-                // Изменение строки состояния лифта согласно последнему принятому сообщению.
+                    break;
+                }
+                case Elevator::Outcoming::Code::InProgress: { break; } // Заглушки.
+                case Elevator::Outcoming::Code::Empty:      { break; }
+                case Elevator::Outcoming::Code::Full:       { break; }
+                case Elevator::Outcoming::Code::Exchanged:  { break; }
+                case Elevator::Outcoming::Code::Boarded:
+                case Elevator::Outcoming::Code::Alighted:
                 {
-                    elevators_floors[elevator] = outcoming.floor; // Обновление этажа лифта.
-
-                    // Список людей.
-                    std::vector<Person> __persons = elevators[elevator].get_persons();
-                    elevators_strings[elevator] = "[";
-                    for (size_t person = 0; person < __persons.size(); ++person)
-                    { elevators_strings[elevator] += std::to_string(__persons[person].destination) + (person + 1 == __persons.size() ? "" : " "); }
-                    elevators_strings[elevator] += "]";
-
-                    // Направление, состояние и прогресс.
-                    switch (outcoming.direction)
-                    {
-                        case Elevator::Direction::None:      { elevators_strings[elevator] += "N"; break; }
-                        case Elevator::Direction::Upwards:   { elevators_strings[elevator] += "U"; break; }
-                        case Elevator::Direction::Downwards: { elevators_strings[elevator] += "D"; break; }
-                    }
-                    switch (outcoming.state)
-                    {
-                        case Elevator::State::Waiting:      { elevators_strings[elevator] += "W"; break; }
-                        case Elevator::State::MovingUp:     { elevators_strings[elevator] += "U"; break; }
-                        case Elevator::State::MovingDown:   { elevators_strings[elevator] += "D"; break; }
-                        case Elevator::State::Opening:      { elevators_strings[elevator] += "O"; break; }
-                        case Elevator::State::Idle:         { elevators_strings[elevator] += "I"; break; }
-                        case Elevator::State::Closing:      { elevators_strings[elevator] += "C"; break; }
-                        case Elevator::State::Embarking:    { elevators_strings[elevator] += "e"; break; }
-                        case Elevator::State::Disembarking: { elevators_strings[elevator] += "d"; break; }
-                    }
-                    elevators_strings[elevator] += ":" + std::to_string(outcoming.progress);
+                    manifest(elevator, outcoming);
+                    break;
                 }
             }
         }
 
-        // Получение требуемого направления.
-        Elevator::Direction direction = Elevator::Direction::None;
-        if (next_person.origin > next_person.destination)       { direction = Elevator::Direction::Downwards; }
-        else if (next_person.origin < next_person.destination)  { direction = Elevator::Direction::Upwards; }
+        // Обновление состояния лифта согласно последнему принятому сообщению.
+        // Вызовы, ещё не доставленные простаивающему лифту, снова назначают ему тик на следующем шаге.
+        fleet.update(elevator, outcoming, timestamp);
+        metrics.state(elevator, fleet.state[elevator], timestamp);
+        for (size_t message = 0; message < elevators_pending[elevator].size(); ++message)
+        {
+            if (elevators_pending[elevator][message].code == Elevator::Incoming::Code::Call) { fleet.touch(elevator); }
+        }
+    }
 
-        // Постановка человека в очередь.
-        floor_persons[next_person.origin].push_back(std::make_pair(direction, next_person));
+    // Промежуточный вывод показателей.
+    if (options.report_interval && !options.interactive && (timestamp >= next_report))
+    {
+        std::ostream& output = *options.output;
+        output << "{\"timestamp\": " << timestamp << ", \"metrics\": ";
+        metrics.print(output, timestamp);
+        output << "}" << std::endl;
+        next_report = (timestamp / options.report_interval + 1) * options.report_interval;
+    }
+
+    // Вызовы лифтов, сменивших состояние, могут оказаться выгоднее для других лифтов.
+    if (options.dispatched && !options.destination)
+    {
+        TRACE_SCOPE("Controller::rebalance");
+        for (size_t index = 0; index < elevators_due.size(); ++index)
+        { rebalance(elevators_due[index]); }
+    }
+}
+void Controller::hall_call(ssize_t floor, Elevator::Direction direction, ssize_t destination)
+{
+    Elevator::Incoming incoming;
+    incoming.id = id_counter++;
+    incoming.timestamp = timestamp;
+    incoming.code = Elevator::Incoming::Code::Call;
+    incoming.floor = floor;
+    incoming.direction = direction;
+    incoming.response = false;
+
+    // Группы лифтов, которым требуется вызов: без ограничений - единственная группа из всех лифтов.
+    if (!is_restricted) { groups_called[0] = 1; }
+    else
+    {
+        std::fill(groups_called.begin(), groups_called.end(), 0);
+        for (size_t group = 0; group < dispatcher.groups(); ++group)
+        {
+            if (!dispatcher.serves(group, floor)) { continue; }
+            if (destination >= 0) { groups_called[group] = dispatcher.serves(group, destination); }
+            for (uint32_t record = floor_queues.first(floor, direction); (destination < 0) && !groups_called[group] && (record != PassengerQueues::end); record = floor_queues.next(record))
+            { groups_called[group] = dispatcher.serves(group, floor_queues.record(record).destination); }
+        }
+    }
+
+    for (size_t group = 0; group < dispatcher.groups(); ++group)
+    {
+        if (!groups_called[group] || dispatcher.members(group).empty()) { continue; }
+        if (!options.dispatched)
+        {
+            const std::vector<size_t>& members = dispatcher.members(group);
+            for (size_t member = 0; member < members.size(); ++member) { post(members[member], incoming); }
+            continue;
+        }
+
+        // Уже назначенный вызов повторно не отправляется.
+        if (dispatcher.assigned(floor, direction, group) != Dispatcher::unassigned) { continue; }
+
+        size_t elevator = dispatcher.select(fleet, floor, direction, group);
+        dispatcher.assign(floor, direction, elevator, timestamp + dispatcher.arrival(fleet, elevator, floor, direction));
+        post(elevator, incoming);
+    }
+}
+void Controller::hall_cancel(size_t elevator, ssize_t floor, Elevator::Direction direction)
+{
+    Elevator::Incoming incoming;
+    incoming.id = id_counter++;
+    incoming.timestamp = timestamp;
+    incoming.code = Elevator::Incoming::Code::Cancel;
+    incoming.floor = floor;
+    incoming.direction = direction;
+    incoming.response = false;
+
+    // При назначении по пунктам назначения вызов снимается только у прибывшего лифта: группы людей, назначенные другим лифтам, ждут их.
+    if (options.destination)
+    {
+        post(elevator, incoming);
+        dispatcher.arrive(elevator, floor, direction);
+        return;
+    }
+
+    // Вызов отменяется только у лифтов группы прибывшего лифта: людей, которых он не повезёт, заберут другие группы.
+    const size_t group = dispatcher.group(elevator);
+    if (!options.dispatched)
+    {
+        const std::vector<size_t>& members = dispatcher.members(group);
+        for (size_t member = 0; member < members.size(); ++member) { post(members[member], incoming); }
+        return;
+    }
+
+    // Вызов отменяется у прибывшего лифта и у лифта, которому он был назначен (если это другой лифт).
+    ssize_t assigned = dispatcher.assigned(floor, direction, group);
+    post(elevator, incoming);
+    if ((assigned != Dispatcher::unassigned) && (static_cast<size_t>(assigned) != elevator)) { post(assigned, incoming); }
+    dispatcher.release(floor, direction, group);
+}
+void Controller::destination_call(ssize_t floor, Elevator::Direction direction, uint32_t record)
+{
+    // Вызов отправляется, только если лифт ещё не едет на этот этаж в этом направлении.
+    bool is_called = false;
+    size_t elevator = dispatcher.assign_person(fleet, floor, direction, floor_queues.record(record).destination, is_called);
+    floor_queues.assign(record, elevator);
+    if (!is_called) { return; }
+
+    Elevator::Incoming incoming;
+    incoming.id = id_counter++;
+    incoming.timestamp = timestamp;
+    incoming.code = Elevator::Incoming::Code::Call;
+    incoming.floor = floor;
+    incoming.direction = direction;
+    incoming.response = false;
+    post(elevator, incoming);
+}
+void Controller::depart(size_t elevator, ssize_t floor)
+{
+    dispatcher.depart(elevator, floor);
+    for (Elevator::Direction direction : { Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+    {
+        // Люди остаются за лифтом, если он ещё вернётся за ними по невыполненному вызову.
+        if (dispatcher.is_calling(elevator, floor, direction)) { continue; }
+        for (uint32_t record = floor_queues.first(floor, direction); record != PassengerQueues::end; record = floor_queues.next(record))
+        {
+            if (floor_queues.record(record).elevator != static_cast<int32_t>(elevator)) { continue; }
+            dispatcher.release_person(elevator);
+            destination_call(floor, direction, record);
+        }
+    }
+}
+bool Controller::boards(size_t elevator, uint32_t record) const
+{
+    if (options.destination) { return floor_queues.record(record).elevator == static_cast<int32_t>(elevator); }
+    return !is_restricted || served[elevator].contains(floor_queues.record(record).destination);
+}
+void Controller::rebalance(size_t elevator)
+{
+    std::vector<std::pair<ssize_t, Elevator::Direction>> assigned;
+    dispatcher.calls(elevator, assigned);
+    for (size_t call = 0; call < assigned.size(); ++call)
+    {
+        ssize_t floor = assigned[call].first;
+        Elevator::Direction direction = assigned[call].second;
+
+        // Лифт, стоящий на этаже вызова, обслужит его сам.
+        if ((fleet.floor[elevator] == floor) && (fleet.state[elevator] != Elevator::State::MovingUp) && (fleet.state[elevator] != Elevator::State::MovingDown))
+        { continue; }
+
+        // Вызов переназначается, только если лифт задерживается, а другой лифт той же группы прибудет заметно раньше.
+        ssize_t best = dispatcher.reassign(fleet, timestamp, elevator, floor, direction);
+        if (best == Dispatcher::unassigned) { continue; }
 
-        // Вызов лифта.
         Elevator::Incoming incoming;
         incoming.id = id_counter++;
         incoming.timestamp = timestamp;
-        incoming.code = Elevator::Incoming::Code::Call;
-        incoming.floor = next_person.origin;
+        incoming.code = Elevator::Incoming::Code::Cancel;
+        incoming.floor = floor;
         incoming.direction = direction;
         incoming.response = false;
+        post(elevator, incoming);
 
-        broadcast(incoming);
+        incoming.id = id_counter++;
+        incoming.code = Elevator::Incoming::Code::Call;
+        post(best, incoming);
+        ++reassigned_count;
     }
 }
-
-// PROTECTED:
+bool Controller::read_header(Checkpoint::Reader& reader, size_t& floors_number, std::vector<Elevator::Settings>& settings)
+{
+    uint64_t floors = 0;
+    if (!reader.read(floors) || !reader.read(settings)) { return false; }
+    floors_number = floors;
+    return true;
+}
 void Controller::broadcast(const Elevator::Incoming& message)
 {
     #ifdef DEBUG_MAIN_MESSAGES
     std::cout << "Броадкаст сообщения с кодом " << static_cast<int>(message.code) << std::endl;
     #endif
     for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+    { post(elevator, message); }
+}
+void Controller::post(size_t elevator, const Elevator::Incoming& message)
+{
+    elevators_pending[elevator].push_back(message);
+    ++posted_count;
+
+    // Простаивавший лифт, получивший вызов, может начать движение уже на следующем тике.
+    if (message.code == Elevator::Incoming::Code::Call) { fleet.touch(elevator); }
+}
+void Controller::flush(size_t elevator)
+{
+    if (elevators_pending[elevator].empty()) { return; }
+
+    #ifdef DEBUG_MAIN_MESSAGES
+    std::cout << "   Лфит " << elevator << ": " << elevators_pending[elevator].size() << " сообщений" << std::endl;
+    #endif
+
+    #ifdef TRANSPORT_INLINE
+    for (size_t message = 0; message < elevators_pending[elevator].size(); ++message)
     {
-        #ifdef DEBUG_MAIN_MESSAGES
-        std::cout << "   Лфит " << elevator << std::endl;
+        const std::vector<Elevator::Outcoming>& outcomings = elevators[elevator].step(elevators_pending[elevator][message]);
+        elevators_outbox[elevator].insert(elevators_outbox[elevator].end(), outcomings.begin(), outcomings.end());
+    }
+    elevators_pending[elevator].clear();
+    #else
+    // В режиме пула лифт выполняется как задача, когда у него появляются сообщения. Получатель почтового ящика работает
+    // только внутри задачи, поэтому сообщения отправляются порциями не больше ёмкости ящика, и задача ставится после каждой:
+    // иначе отправка в заполненный кольцевой буфер ждала бы получателя, который ещё не запущен.
+    const std::vector<Elevator::Incoming>& pending = elevators_pending[elevator];
+    const size_t portion = executor ? std::min(pending.size(), elevators[elevator].inbox.capacity()) : pending.size();
+    for (size_t begin = 0; begin < pending.size(); begin += portion)
+    {
+        const size_t end = std::min(pending.size(), begin + portion);
+        elevators[elevator].inbox.send_batch(pending.begin() + begin, pending.begin() + end);
+        if (executor) { executor->submit(elevator); }
+    }
+    elevators_pending[elevator].clear();
+    #endif
+
+    #ifdef DEBUG_MESSAGE_DELAY
+    std::this_thread::sleep_for(options.delay);
+    #endif
+}
+void Controller::flush()
+{
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+    { flush(elevator); }
+}
+void Controller::collect(size_t elevator, std::vector<Elevator::Outcoming>& outcomings)
+{
+    #ifdef TRANSPORT_INLINE
+    outcomings.insert(outcomings.end(), elevators_outbox[elevator].begin(), elevators_outbox[elevator].end());
+    elevators_outbox[elevator].clear();
+    #else
+    elevators[elevator].outbox.try_receive_all(outcomings);
+    #endif
+}
+Elevator::Outcoming Controller::receive(size_t elevator)
+{
+    // События изменения состава пассажиров применяются к зеркалу и пропускаются.
+    while (true)
+    {
+        #ifdef TRANSPORT_INLINE
+        Elevator::Outcoming outcoming = elevators_outbox[elevator].front();
+        elevators_outbox[elevator].pop_front();
+        #else
+        Elevator::Outcoming outcoming = elevators[elevator].outbox.receive();
         #endif
 
-        elevators[elevator].inbox.send(message);
+        if ((outcoming.code != Elevator::Outcoming::Code::Boarded) && (outcoming.code != Elevator::Outcoming::Code::Alighted))
+        { return outcoming; }
+        manifest(elevator, outcoming);
+    }
+}
+void Controller::manifest(size_t elevator, const Elevator::Outcoming& event)
+{
+    // Зеркало упорядочено по пунктам назначения так же, как пассажиры внутри лифта.
+    std::vector<Person>& persons = manifests[elevator];
+    auto compare = [](const Person& left, const Person& right) { return left.destination < right.destination; };
+    if (event.code == Elevator::Outcoming::Code::Boarded)
+    {
+        persons.insert(std::upper_bound(persons.begin(), persons.end(), event.person, compare), event.person);
+        ++fleet.load[elevator];
+        metrics.boarded(event.person);
+    }
+    else
+    {
+        auto found = std::lower_bound(persons.begin(), persons.end(), event.person, compare);
+        if ((found == persons.end()) || (found->destination != event.person.destination)) { return; }
+        persons.erase(found);
+        --fleet.load[elevator];
+        metrics.alighted(event.person);
+        if (options.alighted) { options.alighted(event.person); }
+    }
+    ++manifests_versions[elevator];
+}
+Elevator::Outcoming Controller::exchange(size_t elevator, ssize_t floor, Elevator::Direction direction)
+{
+    TRACE_SCOPE("Controller::exchange");
 
-        #ifdef DEBUG_MESSAGE_DELAY
-        std::this_thread::sleep_for(delay);
-        #endif
+    // Лифту предлагаются люди из очереди по его направлению (не больше вместимости), которых он должен везти.
+    std::vector<Person>& offered = offers[elevator];
+    uint32_t offered_count = 0;
+    offered_records.clear();
+    if ((direction != Elevator::Direction::None) && (!is_restricted || served[elevator].contains(floor)))
+    {
+        const bool is_selective = is_restricted || options.destination;
+
+        // Если на этаже в том же направлении ещё ждут посадки другие лифты с открытыми дверями и свободными местами, очередь
+        // делится между ними поровну, как при посадке по одному человеку на каждое открытие: иначе первый лифт забирает всех,
+        // а остальные, получив одни и те же вызовы, продолжают двигаться вместе и хуже покрывают здание.
+        // Назначенных лифту людей другие лифты не забирают, поэтому при выборочной посадке очередь не делится.
+        size_t sharing = 1;
+        for (size_t other = 0; !is_selective && (other < fleet.size()); ++other)
+        {
+            const Elevator::State state = fleet.state[other];
+            if ((other == elevator) || (fleet.floor[other] != floor) || (fleet.direction[other] != direction)) { continue; }
+            if ((state != Elevator::State::Opening) && (state != Elevator::State::Idle)) { continue; }
+            if (fleet.load[other] < elevators_settings[other].capacity) { ++sharing; }
+        }
+        size_t waiting = 0;
+        for (uint32_t record = floor_queues.first(floor, direction); (record != PassengerQueues::end) && (waiting < offered.size() * sharing); record = floor_queues.next(record))
+        {
+            if (!is_selective || boards(elevator, record)) { ++waiting; }
+        }
+        const size_t limit = std::min(offered.size(), (waiting + sharing - 1) / sharing);
+
+        uint32_t previous = PassengerQueues::end;
+        for (uint32_t record = floor_queues.first(floor, direction); (record != PassengerQueues::end) && (offered_count < limit); record = floor_queues.next(record))
+        {
+            if (!is_selective || boards(elevator, record))
+            {
+                offered[offered_count++] = floor_queues.person(floor, record);
+                offered_records.push_back(std::make_pair(record, previous));
+            }
+            previous = record;
+        }
+    }
+
+    // Вышедшие и вошедшие люди применяются к зеркалу событиями Alighted и Boarded при получении ответа.
+    Elevator::Incoming incoming;
+    incoming.id = id_counter++;
+    incoming.timestamp = timestamp;
+    incoming.code = Elevator::Incoming::Code::Exchange;
+    incoming.offered_count = offered_count;
+    incoming.response = false;
+    post(elevator, incoming);
+    flush(elevator);
+    Elevator::Outcoming outcoming = receive(elevator);
+    if (outcoming.code != Elevator::Outcoming::Code::Exchanged) { return outcoming; }
+    delivered_count += outcoming.alighted_count;
+
+    // Вошедшие (первые из предложенных) извлекаются из очереди с конца, чтобы предшествующие записи оставались в ней.
+    for (size_t boarded = outcoming.boarded_count; boarded > 0; --boarded)
+    {
+        if (options.destination) { dispatcher.release_person(elevator); }
+        floor_queues.erase(floor, direction, offered_records[boarded - 1].first, offered_records[boarded - 1].second);
     }
+    return outcoming;
 }
-void Controller::print_info()
+std::string Controller::elevator_string(size_t elevator)
 {
-    // Отрисовка состояния лифтов.
-    std::cout << "\033[2J\033[1;1H"; // Очистка экрана.
-    std::cout << "Время: " << timestamp << std::endl;
-    for (size_t floor = 0; floor < floor_persons.size(); ++floor)
+    // Список людей (перестраивается, только если состав пассажиров изменился).
+    if (elevators_strings_versions[elevator] != manifests_versions[elevator])
+    {
+        const std::vector<Person>& persons = manifests[elevator];
+        elevators_strings[elevator] = "[";
+        for (size_t person = 0; person < persons.size(); ++person)
+        { elevators_strings[elevator] += std::to_string(persons[person].destination) + (person + 1 == persons.size() ? "" : " "); }
+        elevators_strings[elevator] += "]";
+        elevators_strings_versions[elevator] = manifests_versions[elevator];
+    }
+    std::string result = elevators_strings[elevator];
+
+    // Направление, состояние и прогресс.
+    switch (fleet.direction[elevator])
+    {
+        case Elevator::Direction::None:      { result += "N"; break; }
+        case Elevator::Direction::Upwards:   { result += "U"; break; }
+        case Elevator::Direction::Downwards: { result += "D"; break; }
+    }
+    switch (fleet.state[elevator])
+    {
+        case Elevator::State::Waiting:      { result += "W"; break; }
+        case Elevator::State::MovingUp:     { result += "U"; break; }
+        case Elevator::State::MovingDown:   { result += "D"; break; }
+        case Elevator::State::Opening:      { result += "O"; break; }
+        case Elevator::State::Idle:         { result += "I"; break; }
+        case Elevator::State::Closing:      { result += "C"; break; }
+        case Elevator::State::Embarking:    { result += "e"; break; }
+        case Elevator::State::Disembarking: { result += "d"; break; }
+    }
+    result += ":" + std::to_string(fleet.current_progress(elevator, timestamp));
+    return result;
+}
+void Controller::render(bool force)
+{
+    if (!renderer || (!force && !renderer->requested())) { return; }
+    TRACE_SCOPE("Controller::render");
+
+    // Строки состояния лифтов.
+    std::vector<std::string> strings(elevators.size());
+    for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
+    { strings[elevator] = elevator_string(elevator); }
+
+    // Построение кадра: время и по строке на каждый этаж.
+    frame.resize(floor_queues.floors() + 1);
+    frame[0] = "Время: " + std::to_string(timestamp);
+    for (size_t floor = 0; floor < floor_queues.floors(); ++floor)
     {
         // Номер этажа.
-        std::cout << floor << ". ";
+        std::string& line = frame[floor + 1];
+        line = std::to_string(floor) + ". ";
 
         // Отрисовка лифтов.
         for (size_t elevator = 0; elevator < elevators.size(); ++elevator)
         {
-            if (elevators_floors[elevator] == floor) { std::cout << elevators_strings[elevator]; }
-            else
-            {
-                for (size_t i = 0; i < elevators_strings[elevator].size(); ++i)
-                { std::cout << " "; }
-            }
-            std::cout << "|";
+            if (fleet.floor[elevator] == static_cast<ssize_t>(floor)) { line += strings[elevator]; }
+            else { line.append(strings[elevator].size(), ' '); }
+            line += "|";
         }
 
         // Отрисовка очереди людей.
-        for (auto iterator = floor_persons[floor].begin(); iterator != floor_persons[floor].end(); ++iterator)
-        { std::cout << iterator->second.destination << " "; }
-        std::cout << std::endl;
+        for (Elevator::Direction direction : { Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+        {
+            for (uint32_t record = floor_queues.first(floor, direction); record != PassengerQueues::end; record = floor_queues.next(record))
+            { line += std::to_string(floor_queues.record(record).destination) + " "; }
+        }
     }
+    renderer->publish(frame);
 }
 
 // PRIVATE:
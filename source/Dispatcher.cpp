@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "Dispatcher.hpp"
+
+////////////////   Dispatcher   ////////////////
+// Централизованное распределение вызовов с этажей.
+// PUBLIC:
+Dispatcher::Dispatcher(size_t floors_number, const std::vector<Elevator::Settings>& init_settings, const std::vector<FloorMask>& masks)
+{
+    floors = floors_number;
+    elevators_settings = init_settings;
+
+    // Лифты объединяются в группы по наборам обслуживаемых этажей (без наборов - все лифты в одной группе).
+    for (size_t elevator = 0; elevator < elevators_settings.size(); ++elevator)
+    {
+        FloorMask mask = (elevator < masks.size()) ? masks[elevator] : FloorMask(floors_number);
+        size_t group = 0;
+        while ((group < groups_masks.size()) && !(groups_masks[group] == mask)) { ++group; }
+        if (group == groups_masks.size())
+        {
+            groups_masks.push_back(mask);
+            groups_members.emplace_back();
+        }
+        elevators_groups.push_back(group);
+        groups_members[group].push_back(elevator);
+    }
+    if (groups_masks.empty())
+    {
+        groups_masks.push_back(FloorMask(floors_number));
+        groups_members.emplace_back();
+    }
+
+    floor_assignments[0] = std::vector<ssize_t>(groups() * floors_number, unassigned);
+    floor_assignments[1] = std::vector<ssize_t>(groups() * floors_number, unassigned);
+    for (size_t index : { 0, 1 })
+    {
+        floor_expected[index] = std::vector<tick_t>(groups() * floors_number, Elevator::never);
+        floor_previous[index] = std::vector<ssize_t>(groups() * floors_number, unassigned);
+    }
+    reserved = std::vector<uint64_t>(elevators_settings.size(), 0);
+    elevator_calls = std::vector<CallRegistry>(elevators_settings.size(), CallRegistry(floors_number));
+}
+
+ssize_t Dispatcher::assigned(ssize_t floor, Elevator::Direction direction, size_t group) const
+{
+    return floor_assignments[_index(direction)][group * floors + floor];
+}
+void Dispatcher::assign(ssize_t floor, Elevator::Direction direction, size_t elevator, tick_t expected)
+{
+    release(floor, direction, group(elevator));
+
+    const size_t index = group(elevator) * floors + floor;
+    floor_assignments[_index(direction)][index] = static_cast<ssize_t>(elevator);
+    floor_expected[_index(direction)][index] = expected;
+    elevator_calls[elevator].insert(_group(direction), floor);
+}
+void Dispatcher::release(ssize_t floor, Elevator::Direction direction, size_t group)
+{
+    const size_t index = group * floors + floor;
+    ssize_t& elevator = floor_assignments[_index(direction)][index];
+    if (elevator == unassigned) { return; }
+
+    elevator_calls[elevator].erase(_group(direction), floor);
+    elevator = unassigned;
+    floor_expected[_index(direction)][index] = Elevator::never;
+    floor_previous[_index(direction)][index] = unassigned;
+}
+
+void Dispatcher::sectorize(size_t init_sectors_number)
+{
+    if (init_sectors_number == 0)
+    {
+        // По умолчанию сектор охватывает примерно столько этажей, сколько людей вмещает лифт: группы получаются
+        // достаточно крупными, чтобы заполнять лифты, а секторов - заметно меньше, чем этажей.
+        uint64_t capacity = 1;
+        for (const Elevator::Settings& settings : elevators_settings) { capacity = std::max(capacity, settings.capacity); }
+        init_sectors_number = std::min<size_t>((floors + capacity - 1) / capacity, std::max<size_t>(1, floors / 4));
+    }
+    sectors_number = std::max<size_t>(1, std::min(init_sectors_number, floors));
+    sector_assignments[0] = std::vector<ssize_t>(floors * sectors_number, unassigned);
+    sector_assignments[1] = std::vector<ssize_t>(floors * sectors_number, unassigned);
+}
+size_t Dispatcher::assign_person(const ElevatorFleet& fleet, ssize_t floor, Elevator::Direction direction, ssize_t destination, bool& is_called)
+{
+    // Группа продолжает набираться в свой лифт, пока в нём есть места и он ещё едет на этаж (у стоящего лифта посадка может быть уже завершена).
+    ssize_t& current = sector_assignments[_index(direction)][floor * sectors_number + sector(destination)];
+    auto has_room = [&](size_t elevator) { return fleet.load[elevator] + reserved[elevator] < elevators_settings[elevator].capacity; };
+    size_t elevator = (current == unassigned) ? 0 : static_cast<size_t>(current);
+    if ((current == unassigned) || !has_room(elevator) || !is_calling(elevator, floor, direction))
+    {
+        // Иначе выбирается лифт, обслуживающий этаж и пункт назначения, с наименьшим оценочным временем прибытия
+        // (лифты без свободных мест - только в крайнем случае).
+        tick_t best_estimate = Elevator::never;
+        for (size_t candidate = 0; candidate < elevators_settings.size(); ++candidate)
+        {
+            if (!serves(group(candidate), floor) || !serves(group(candidate), destination)) { continue; }
+            tick_t estimated = estimate(fleet, candidate, floor, direction) + (has_room(candidate) ? 0 : Elevator::never / 4);
+            if ((estimated < best_estimate) || (best_estimate == Elevator::never))
+            {
+                elevator = candidate;
+                best_estimate = estimated;
+            }
+        }
+        current = static_cast<ssize_t>(elevator);
+    }
+
+    ++reserved[elevator];
+    is_called = !elevator_calls[elevator].contains(_group(direction), floor);
+    elevator_calls[elevator].insert(_group(direction), floor);
+    return elevator;
+}
+bool Dispatcher::is_calling(size_t elevator, ssize_t floor, Elevator::Direction direction) const
+{
+    return (elevator < elevator_calls.size()) && elevator_calls[elevator].contains(_group(direction), floor);
+}
+void Dispatcher::arrive(size_t elevator, ssize_t floor, Elevator::Direction direction)
+{
+    // Вызов снимается сразу, а назначенные люди остаются за лифтом, пока он их сажает.
+    if (elevator < elevator_calls.size()) { elevator_calls[elevator].erase(_group(direction), floor); }
+}
+void Dispatcher::depart(size_t elevator, ssize_t floor)
+{
+    if (elevator >= elevator_calls.size()) { return; }
+
+    // Группы перестают набираться в лифт по направлениям, вызов по которым он уже обслужил (назначенные за время стоянки остаются).
+    for (Elevator::Direction direction : { Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+    {
+        if (elevator_calls[elevator].contains(_group(direction), floor)) { continue; }
+        ssize_t* assignments = &sector_assignments[_index(direction)][floor * sectors_number];
+        for (size_t sector = 0; sector < sectors_number; ++sector)
+        {
+            if (assignments[sector] == static_cast<ssize_t>(elevator)) { assignments[sector] = unassigned; }
+        }
+    }
+}
+size_t Dispatcher::select(const ElevatorFleet& fleet, ssize_t floor, Elevator::Direction direction, size_t group) const
+{
+    const std::vector<size_t>& candidates = groups_members[group];
+    size_t best = candidates.empty() ? 0 : candidates.front();
+    tick_t best_estimate = Elevator::never;
+    for (size_t candidate = 0; candidate < candidates.size(); ++candidate)
+    {
+        const size_t elevator = candidates[candidate];
+        tick_t current = estimate(fleet, elevator, floor, direction);
+        if (current < best_estimate)
+        {
+            best = elevator;
+            best_estimate = current;
+        }
+    }
+    return best;
+}
+ssize_t Dispatcher::reassign(const ElevatorFleet& fleet, tick_t timestamp, size_t elevator, ssize_t floor, Elevator::Direction direction)
+{
+    const size_t index = group(elevator) * floors + floor;
+    tick_t& expected = floor_expected[_index(direction)][index];
+    const tick_t current = timestamp + arrival(fleet, elevator, floor, direction);
+    if (current <= expected) { return unassigned; }
+    expected = current;
+
+    // Оба лифта оцениваются одинаково - с остановкой по вызову; заполненный лифт выбирается только в крайнем случае.
+    const ssize_t previous = floor_previous[_index(direction)][index];
+    const std::vector<size_t>& candidates = groups_members[group(elevator)];
+    size_t best = elevator;
+    tick_t best_arrival = Elevator::never;
+    for (size_t candidate = 0; candidate < candidates.size(); ++candidate)
+    {
+        const size_t other = candidates[candidate];
+        if ((other == elevator) || (static_cast<ssize_t>(other) == previous)) { continue; }
+        tick_t estimated = timestamp + arrival(fleet, other, floor, direction);
+        if (fleet.load[other] >= elevators_settings[other].capacity) { estimated += Elevator::never / 4; }
+        if (estimated < best_arrival)
+        {
+            best = other;
+            best_arrival = estimated;
+        }
+    }
+    if ((best == elevator) || (best_arrival + std::max(_stop(elevator), _stop(best)) >= current)) { return unassigned; }
+
+    assign(floor, direction, best, best_arrival);
+    floor_previous[_index(direction)][index] = static_cast<ssize_t>(elevator);
+    return static_cast<ssize_t>(best);
+}
+tick_t Dispatcher::estimate(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const
+{
+    // Заполненный лифт никого не заберёт, поэтому он выбирается только в крайнем случае.
+    tick_t result = _travel(fleet, elevator, floor, direction);
+    if (fleet.load[elevator] >= elevators_settings[elevator].capacity) { result += Elevator::never / 4; }
+    return result;
+}
+tick_t Dispatcher::arrival(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const
+{
+    // Остановка по вызову уже учтена в оценке, если вызов назначен лифту.
+    tick_t result = _travel(fleet, elevator, floor, direction);
+    if (!is_calling(elevator, floor, direction)) { result += _stop(elevator); }
+    return result;
+}
+void Dispatcher::calls(size_t elevator, std::vector<std::pair<ssize_t, Elevator::Direction>>& result) const
+{
+    result.clear();
+    if (elevator >= elevator_calls.size()) { return; }
+
+    const CallRegistry& registry = elevator_calls[elevator];
+    for (Elevator::Direction direction : { Elevator::Direction::Upwards, Elevator::Direction::Downwards })
+    {
+        for (ssize_t floor = registry.at_or_above(_group(direction), 0); floor != CallRegistry::none; floor = registry.at_or_above(_group(direction), floor + 1))
+        { result.push_back(std::make_pair(floor, direction)); }
+    }
+}
+
+void Dispatcher::store(Checkpoint& checkpoint) const
+{
+    checkpoint.write(floor_assignments[0]);
+    checkpoint.write(floor_assignments[1]);
+    checkpoint.write(floor_expected[0]);
+    checkpoint.write(floor_expected[1]);
+    checkpoint.write(floor_previous[0]);
+    checkpoint.write(floor_previous[1]);
+    checkpoint.write(sector_assignments[0]);
+    checkpoint.write(sector_assignments[1]);
+    checkpoint.write(reserved);
+    checkpoint.write<uint64_t>(elevator_calls.size());
+    for (size_t elevator = 0; elevator < elevator_calls.size(); ++elevator) { elevator_calls[elevator].store(checkpoint); }
+}
+bool Dispatcher::restore(Checkpoint::Reader& reader)
+{
+    uint64_t elevators_number = 0;
+    if (!reader.read(floor_assignments[0]) || !reader.read(floor_assignments[1]) ||
+        !reader.read(floor_expected[0]) || !reader.read(floor_expected[1]) || !reader.read(floor_previous[0]) || !reader.read(floor_previous[1]) ||
+        !reader.read(sector_assignments[0]) || !reader.read(sector_assignments[1]) || !reader.read(reserved) || !reader.read(elevators_number))
+    { return false; }
+    // Точка должна соответствовать текущим лифтам, группам и секторам, а назначения - ссылаться на существующие лифты.
+    if ((floor_assignments[0].size() != groups() * floors) || (floor_assignments[1].size() != floor_assignments[0].size()) ||
+        (floor_expected[0].size() != floor_assignments[0].size()) || (floor_expected[1].size() != floor_assignments[0].size()) ||
+        (floor_previous[0].size() != floor_assignments[0].size()) || (floor_previous[1].size() != floor_assignments[0].size()) ||
+        (sector_assignments[0].size() != sectors_number * floors) || (sector_assignments[1].size() != sector_assignments[0].size()) ||
+        (reserved.size() != elevators_settings.size()) || (elevators_number != elevators_settings.size()))
+    { return reader.fail(); }
+    auto is_valid = [this](ssize_t elevator) { return (elevator >= unassigned) && (elevator < static_cast<ssize_t>(elevators_settings.size())); };
+    for (const std::vector<ssize_t>* assignments : { &floor_assignments[0], &floor_assignments[1], &floor_previous[0], &floor_previous[1],
+                                                     &sector_assignments[0], &sector_assignments[1] })
+    {
+        if (!std::all_of(assignments->begin(), assignments->end(), is_valid)) { return reader.fail(); }
+    }
+
+    for (size_t elevator = 0; elevator < elevator_calls.size(); ++elevator)
+    {
+        if (!elevator_calls[elevator].restore(reader)) { return false; }
+    }
+    return true;
+}
+
+// PROTECTED:
+tick_t Dispatcher::_travel(const ElevatorFleet& fleet, size_t elevator, ssize_t floor, Elevator::Direction direction) const
+{
+    const ssize_t position = fleet.floor[elevator];
+    const Elevator::State state = fleet.state[elevator];
+
+    // Время до ближайшей смены состояния (для движущегося лифта - до прибытия на следующий этаж).
+    tick_t result = 0;
+    ssize_t start = position;
+    if (state != Elevator::State::Waiting)
+    {
+        result += (fleet.remaining[elevator] == ElevatorFleet::never) ? 0 : fleet.remaining[elevator];
+        if (state == Elevator::State::MovingUp)   { ++start; }
+        if (state == Elevator::State::MovingDown) { --start; }
+    }
+
+    // Назначенные лифту вызовы: по ним определяется точка разворота и число промежуточных остановок.
+    size_t stops = 0;
+    ssize_t highest = start;
+    ssize_t lowest = start;
+    if (elevator < elevator_calls.size())
+    {
+        const CallRegistry& calls = elevator_calls[elevator];
+        for (size_t group = 1; group < CallRegistry::groups; ++group)
+        {
+            stops += calls.size(group);
+            ssize_t top = calls.below(group, static_cast<ssize_t>(floors));
+            ssize_t bottom = calls.at_or_above(group, 0);
+            if (top != CallRegistry::none)    { highest = std::max(highest, top); }
+            if (bottom != CallRegistry::none) { lowest = std::min(lowest, bottom); }
+        }
+    }
+
+    // Путь до этажа вызова: напрямую, если вызов по ходу движения, иначе через точку разворота.
+    ssize_t distance = std::abs(floor - start);
+    const Elevator::Direction moving = fleet.direction[elevator];
+    if ((moving == Elevator::Direction::Upwards) && ((floor < start) || (direction == Elevator::Direction::Downwards)))
+    { distance = (highest - start) + std::abs(highest - floor); }
+    else if ((moving == Elevator::Direction::Downwards) && ((floor > start) || (direction == Elevator::Direction::Upwards)))
+    { distance = (start - lowest) + std::abs(floor - lowest); }
+
+    result += static_cast<tick_t>(distance) * elevators_settings[elevator].stage;
+    // Назначенные лифту, но ещё не вошедшие люди (при назначении по пунктам назначения) займут его так же, как пассажиры.
+    const uint64_t waiting = (elevator < reserved.size()) ? reserved[elevator] : 0;
+    result += static_cast<tick_t>(stops + fleet.load[elevator] + waiting) * _stop(elevator);
+    return result;
+}
+
+// PRIVATE:
@@ -1,40 +1,27 @@
 #include "Elevator.hpp"
+#include <algorithm>
 #include <iostream>
 
 //#define DEBUG_SWITCH_STATE
 //#define DEBUG_MESSAGE
 //#define DEBUG_SWITCH_CLOSEST
 
+#ifdef TRACE
+// Имена интервалов трассировки для кодов входящих сообщений.
+static const char* trace_names[] = { "Elevator::Tick", "Elevator::Call", "Elevator::Cancel", "Elevator::Embark", "Elevator::Disembark", "Elevator::Stop", "Elevator::Exchange" };
+#endif
+
 ////////////////    Elevator    ////////////////
 // Класс логики лифта.
 // PUBLIC:
-Elevator::Elevator(const Settings& init_settings)
+Elevator::Elevator(const Settings& init_settings, size_t floors_number)
 {
     _settings = init_settings;
-    calls[Direction::None] = std::set<ssize_t>();
-    calls[Direction::Upwards] = std::set<ssize_t>();
-    calls[Direction::Downwards] = std::set<ssize_t>();
-}
-Elevator::Elevator(const Elevator& elevator)
-{
-    // TODO: потокобезопасное копирование.
-    id_counter = elevator.id_counter;
-    timestamp = elevator.timestamp;
-    progress = elevator.progress;
-    floor = elevator.floor;
-    state = elevator.state;
-
-    // Обработка активного вызова.
-    is_destination_selected = elevator.is_destination_selected;
-    is_ignoring_other = elevator.is_ignoring_other;
-    destination = elevator.destination;
-    direction = elevator.direction;
-
-    _settings = elevator._settings;
-    floor_person = elevator.floor_person;
-    calls = elevator.calls;
-    inbox = elevator.inbox;
-    outbox = elevator.outbox;
+    calls.reserve(floors_number);
+
+    // Память под пассажиров выделяется один раз по вместимости лифта.
+    persons.reserve(_settings.capacity);
+    destination_counts = std::vector<uint32_t>(floors_number, 0);
 }
 Elevator::~Elevator()
 {
@@ -45,155 +32,269 @@ void Elevator::loop() // Цикл работы.
 {
     while (working.load())
     {
-        // Извлечение сообщений, если они есть.
+        // Извлечение сообщений, если они есть, и отправка ответов одной пачкой.
         Incoming incoming = inbox.receive();
+        const std::vector<Outcoming>& outcomings = step(incoming);
+        outbox.send_batch(outcomings.begin(), outcomings.end());
+        if (incoming.response && countdown) { countdown->arrive(); }
+    }
+}
+const std::vector<Elevator::Outcoming>& Elevator::step(const Incoming& incoming) // Синхронная обработка сообщения.
+{
+    outgoing.clear();
+    handle(incoming);
+    return outgoing;
+}
+bool Elevator::poll() // Обработка всех уже поступивших сообщений без ожидания.
+{
+    bool is_handled = false;
+    Incoming incoming;
+    while (working.load() && inbox.try_receive(incoming))
+    {
+        const std::vector<Outcoming>& outcomings = step(incoming);
+        outbox.send_batch(outcomings.begin(), outcomings.end());
+        if (incoming.response && countdown) { countdown->arrive(); }
+        is_handled = true;
+    }
+    return is_handled;
+}
+void Elevator::store(Checkpoint& checkpoint) const
+{
+    checkpoint.write(id_counter);
+    checkpoint.write(timestamp);
+    checkpoint.write(state);
+    checkpoint.write(progress);
+    checkpoint.write(dwell);
+
+    checkpoint.write(floor);
+    checkpoint.write(is_destination_selected);
+    checkpoint.write(is_ignoring_other);
+    checkpoint.write(destination);
+    checkpoint.write(direction);
+
+    checkpoint.write(persons);
+    calls.store(checkpoint);
+}
+bool Elevator::restore(Checkpoint::Reader& reader)
+{
+    bool is_read = reader.read(id_counter) && reader.read(timestamp) && reader.read(state) && reader.read(progress) &&
+                   reader.read(dwell) && reader.read(floor) && reader.read(is_destination_selected) && reader.read(is_ignoring_other) &&
+                   reader.read(destination) && reader.read(direction) &&
+                   reader.read(persons) && calls.restore(reader);
+    if (!is_read) { return false; }
+
+    // Число выходящих на каждом этаже восстанавливается по пассажирам.
+    persons.reserve(_settings.capacity);
+    std::fill(destination_counts.begin(), destination_counts.end(), 0);
+    for (size_t person = 0; person < persons.size(); ++person)
+    {
+        if ((persons[person].destination < 0) || (static_cast<size_t>(persons[person].destination) >= destination_counts.size()))
+        { return reader.fail(); }
+        ++destination_counts[persons[person].destination];
+    }
+    return true;
+}
 
-        #ifdef DEBUG_MESSAGE
-        std::cout << "Получено сообщение. ID: " << incoming.id << " Код: " << static_cast<int>(incoming.code) << std::endl << std::endl;
-        #endif
+// PROTECTED:
+void Elevator::handle(const Incoming& incoming) // Обработка одного сообщения (ответы копятся в outgoing).
+{
+    TRACE_SCOPE(trace_names[static_cast<size_t>(incoming.code)]);
+    #ifdef DEBUG_MESSAGE
+    std::cout << "Получено сообщение. ID: " << incoming.id << " Код: " << static_cast<int>(incoming.code) << std::endl << std::endl;
+    #endif
 
-        // Обработка сообщения.
-        switch (incoming.code)
+    // Обработка сообщения.
+    switch (incoming.code)
+    {
+        // Прошёл интервал времени.
+        case Incoming::Code::Tick:
         {
-            // Прошёл интервал времени.
-            case Incoming::Code::Tick:
+            timestamp += incoming.delta_tick;
+            progress += incoming.delta_tick;
+            while (switch_state());
+            if (state == State::Waiting) { progress = 0; }
+
+            #ifdef DEBUG_SWITCH_STATE
             {
-                timestamp += incoming.delta_tick;
-                progress += incoming.delta_tick;
-                while (switch_state());
-                if (state == State::Waiting) { progress = 0; }
+                size_t __size = persons.size();
+                std::cout << "Время: " << timestamp << std::endl
+                          << "Этаж: " << floor
+                          << "; направление: " << static_cast<int>(direction) << " (" << is_destination_selected << "|" << is_ignoring_other << ")"
+                          << "; загруженность: " << __size << "/" << _settings.capacity << std::endl
+                          << "Состояние: " << static_cast<int>(state) << " (" << progress << ")" << std::endl << std::endl;
+            }
+            #endif
+            break;
+        }
+        // Вызов.
+        case Incoming::Code::Call:
+        {
+            insert_call(incoming.floor, incoming.direction);
+            break;
+        }
+        // Отмена вызова.
+        case Incoming::Code::Cancel:
+        {
+            erase_call(incoming.floor, incoming.direction);
+            break;
+        }
+        case Incoming::Code::Embark:
+        {
+            Outcoming::Code code = Outcoming::Code::Success;
 
-                #ifdef DEBUG_SWITCH_STATE
+            // Если лифт ожидает с открытыми дверями.
+            if (state == State::Idle)
+            {
+                if (persons.size() >= _settings.capacity)
+                { code = Outcoming::Code::Full; }
+                // Человек с пунктом назначения вне здания не допускается (счётчики выходящих заданы по числу этажей).
+                else if (!is_floor(incoming.person.destination))
+                { code = Outcoming::Code::Denied; }
+                else
                 {
-                    size_t __size = floor_person.size();
-                    {
-                        std::shared_lock<std::shared_mutex> lock(mutex_floor_person);
-                        __size = floor_person.size();
-                    }
-                    std::cout << "Время: " << timestamp << std::endl
-                              << "Этаж: " << floor
-                              << "; направление: " << static_cast<int>(direction) << " (" << is_destination_selected << "|" << is_ignoring_other << ")"
-                              << "; загруженность: " << __size << "/" << _settings.capacity << std::endl
-                              << "Состояние: " << static_cast<int>(state) << " (" << progress << ")" << std::endl << std::endl;
+                    Person entered_person = incoming.person;
+                    entered_person.boarded = incoming.timestamp;
+                    persons.push_back(entered_person);
+                    ++destination_counts[entered_person.destination];
+                    progress = 0;
+                    dwell = _settings.in;
+                    state = State::Embarking;
+
+                    // Изменение состава пассажиров сообщается отдельным событием перед ответом.
+                    Outcoming event = _create_outcoming(Outcoming::Code::Boarded);
+                    event.person = entered_person;
+                    outgoing.push_back(event);
                 }
-                #endif
-                break;
             }
-            // Вызов.
-            case Incoming::Code::Call:
-            {
-                insert_call(incoming.floor, incoming.direction);
-                break;
-            }
-            // Отмена вызова.
-            case Incoming::Code::Cancel:
+            // Если происходит посадка/высадка.
+            else if ((state == State::Embarking) || (state == State::Disembarking))
+            { code = Outcoming::Code::InProgress; }
+            // Если двери закрыты.
+            else
+            { code = Outcoming::Code::Denied; }
+
+            // Ответ формируется после изменения состояния, чтобы отражать его актуальным.
+            outgoing.push_back(_create_outcoming(code));
+            break;
+        }
+        case Incoming::Code::Disembark:
+        {
+            Outcoming::Code code = Outcoming::Code::Success;
+
+            // Если лифт ожидает с открытыми дверями.
+            if (state == State::Idle)
             {
-                erase_call(incoming.floor, incoming.direction);
-                break;
+                // Если людей на выход для текущего этажа нет.
+                if ((static_cast<size_t>(floor) >= destination_counts.size()) || (destination_counts[floor] == 0))
+                { code = Outcoming::Code::Empty; }
+                // Иначе извлекается первый вошедший из выходящих на этом этаже.
+                else
+                {
+                    auto found = std::find_if(persons.begin(), persons.end(), [this](const Person& person) { return person.destination == floor; });
+                    Person left_person = *found;
+                    left_person.alighted = incoming.timestamp;
+                    persons.erase(found);
+                    --destination_counts[floor];
+                    progress = 0;
+                    dwell = _settings.out;
+                    state = State::Disembarking;
+
+                    // Изменение состава пассажиров сообщается отдельным событием перед ответом.
+                    Outcoming event = _create_outcoming(Outcoming::Code::Alighted);
+                    event.person = left_person;
+                    outgoing.push_back(event);
+                }
             }
-            case Incoming::Code::Embark:
-            {
-                Outcoming outcoming = _create_outcoming(Outcoming::Code::Success);
+            // Если происходит посадка/высадка.
+            else if ((state == State::Embarking) || (state == State::Disembarking))
+            { code = Outcoming::Code::InProgress; }
+            // Если двери закрыты.
+            else
+            { code = Outcoming::Code::Denied; }
+
+            // Ответ формируется после изменения состояния, чтобы отражать его актуальным.
+            outgoing.push_back(_create_outcoming(code));
+            break;
+        }
+        // Завершение работы.
+        case Incoming::Code::Stop:
+        {
+            working.store(false);
+            break;
+        }
+        case Incoming::Code::Exchange:
+        {
+            Outcoming::Code code = Outcoming::Code::Exchanged;
+            uint32_t alighted = 0;
+            uint32_t boarded = 0;
 
-                // Если лифт ожидает с открытыми дверями.
-                if (state == State::Idle)
+            // Если лифт ожидает с открытыми дверями.
+            if (state == State::Idle)
+            {
+                // Выходят все, для кого этот этаж - пункт назначения (в порядке входа).
+                if (is_floor(floor) && (destination_counts[floor] != 0))
                 {
-                    std::unique_lock<std::shared_mutex> lock(mutex_floor_person);
-                    if (floor_person.size() >= _settings.capacity)
-                    { outcoming.code = Outcoming::Code::Full; }
-                    else
+                    auto staying = std::stable_partition(persons.begin(), persons.end(), [this](const Person& person) { return person.destination != floor; });
+                    for (auto left_person = staying; left_person != persons.end(); ++left_person)
                     {
-                        Person entered_person = incoming.person;
-                        floor_person.insert(std::pair<size_t, Person>(entered_person.destination, entered_person));
-                        progress = 0;
-                        state = State::Embarking;
+                        Outcoming event = _create_outcoming(Outcoming::Code::Alighted);
+                        event.person = *left_person;
+                        event.person.alighted = incoming.timestamp;
+                        outgoing.push_back(event);
+                        ++alighted;
                     }
+                    persons.erase(staying, persons.end());
+                    destination_counts[floor] = 0;
                 }
-                // Если происходит посадка/высадка.
-                else if ((state == State::Embarking) || (state == State::Disembarking))
-                { outcoming.code = Outcoming::Code::InProgress; }
-                // Если двери закрыты.
-                else
-                { outcoming.code = Outcoming::Code::Denied; }
-
-                outbox.send(outcoming);
-                break;
-            }
-            case Incoming::Code::Disembark:
-            {
-                Outcoming outcoming = _create_outcoming(Outcoming::Code::Success);
 
-                // Если лифт ожидает с открытыми дверями.
-                if (state == State::Idle)
+                // Входят предложенные люди в порядке очереди, пока есть места; их пункты назначения становятся вызовами.
+                // Посадка прекращается на первом человеке с пунктом назначения вне здания.
+                for (uint32_t offered = 0; (offered < incoming.offered_count) && (persons.size() < _settings.capacity); ++offered)
                 {
-                    std::unique_lock<std::shared_mutex> lock(mutex_floor_person);
-                    auto found = floor_person.find(floor);
-                    // Если людей на выход для текущего этажа нет.
-                    if (found == floor_person.end())
-                    { outcoming.code = Outcoming::Code::Empty; }
-                    // Иначе человек извлекается.
-                    else
-                    {
-                        floor_person.erase(found);
-                        progress = 0;
-                        state = State::Disembarking;
-                    }
+                    if (!is_floor(offers[offered].destination)) { break; }
+                    Person entered_person = offers[offered];
+                    entered_person.boarded = incoming.timestamp;
+                    persons.push_back(entered_person);
+                    ++destination_counts[entered_person.destination];
+                    insert_call(entered_person.destination, Direction::None);
+
+                    Outcoming event = _create_outcoming(Outcoming::Code::Boarded);
+                    event.person = entered_person;
+                    outgoing.push_back(event);
+                    ++boarded;
                 }
-                // Если происходит посадка/высадка.
-                else if ((state == State::Embarking) || (state == State::Disembarking))
-                { outcoming.code = Outcoming::Code::InProgress; }
-                // Если двери закрыты.
-                else
-                { outcoming.code = Outcoming::Code::Denied; }
 
-                outbox.send(outcoming);
-                break;
+                // Двери заняты на время выхода и входа всех людей сразу.
+                if ((alighted != 0) || (boarded != 0))
+                {
+                    progress = 0;
+                    dwell = alighted * _settings.out + boarded * _settings.in;
+                    state = (alighted != 0) ? State::Disembarking : State::Embarking;
+                }
             }
-        }
-
-        // В случае, если требуется ответ, происходит отправка требуемого сообщения.
-        if (incoming.response)
-        {
-            Outcoming outcoming = _create_outcoming(Outcoming::Code::Response);
-            outbox.send(outcoming);
+            // Если происходит посадка/высадка.
+            else if ((state == State::Embarking) || (state == State::Disembarking))
+            { code = Outcoming::Code::InProgress; }
+            // Если двери закрыты.
+            else
+            { code = Outcoming::Code::Denied; }
+
+            // Ответ формируется после изменения состояния, чтобы отражать его актуальным.
+            Outcoming outcoming = _create_outcoming(code);
+            outcoming.alighted_count = alighted;
+            outcoming.boarded_count = boarded;
+            outgoing.push_back(outcoming);
+            break;
         }
     }
-}
-std::vector<Person> Elevator::get_persons() // Получение массива находящихся в лифте людей.
-{
-    std::shared_lock<std::shared_mutex> lock(mutex_floor_person);
-    std::vector<Person> result;
-    result.reserve(floor_person.size());
-    for (auto iterator = floor_person.begin(); iterator != floor_person.end(); ++ iterator)
-    { result.push_back(iterator->second); }
-    return result;
-}
 
-Elevator& Elevator::operator=(const Elevator& elevator)
-{
-    // TODO: потокобезопасное копирование.
-    id_counter = elevator.id_counter;
-    timestamp = elevator.timestamp;
-    progress = elevator.progress;
-    floor = elevator.floor;
-    state = elevator.state;
-
-    // Обработка активного вызова.
-    is_destination_selected = elevator.is_destination_selected;
-    is_ignoring_other = elevator.is_ignoring_other;
-    destination = elevator.destination;
-    direction = elevator.direction;
-
-    _settings = elevator._settings;
-    floor_person = elevator.floor_person;
-    calls = elevator.calls;
-    inbox = elevator.inbox;
-    outbox = elevator.outbox;
-
-    return *this;
+    // В случае, если требуется ответ, происходит отправка требуемого сообщения.
+    if (incoming.response)
+    {
+        Outcoming outcoming = _create_outcoming(Outcoming::Code::Response);
+        outgoing.push_back(outcoming);
+    }
 }
-
-// PROTECTED:
 bool Elevator::switch_state() // Изменить состояние лифта.
 {
     switch (state)
@@ -232,7 +333,7 @@ bool Elevator::switch_state() // Изменить состояние лифта.
                 progress -= _settings.open;
                 state = State::Idle;
                 Outcoming outcoming = _create_outcoming(Outcoming::Code::Idling);
-                outbox.send(outcoming);
+                outgoing.push_back(outcoming);
             }
             break;
         }
@@ -257,56 +358,81 @@ bool Elevator::switch_state() // Изменить состояние лифта.
         }
         case State::Embarking:
         {
-            if (progress >= _settings.in)
+            if (progress >= dwell)
             {
-                progress -= _settings.in;
+                progress -= dwell;
                 state = State::Idle;
                 Outcoming outcoming = _create_outcoming(Outcoming::Code::Idling);
-                outbox.send(outcoming);
+                outgoing.push_back(outcoming);
             }
             break;
         }
         case State::Disembarking:
         {
-            if (progress >= _settings.out)
+            if (progress >= dwell)
             {
-                progress -= _settings.out;
+                progress -= dwell;
                 state = State::Idle;
                 Outcoming outcoming = _create_outcoming(Outcoming::Code::Idling);
-                outbox.send(outcoming);
+                outgoing.push_back(outcoming);
             }
             break;
         }
     }
     return false;
 }
+// Время до ближайшего изменения состояния.
+tick_t Elevator::next_event()
+{
+    tick_t threshold = 0;
+    switch (state)
+    {
+        // В режиме ожидания состояние меняется только при наличии вызовов.
+        case State::Waiting:
+        {
+            return calls.empty() ? never : 1;
+        }
+        case State::MovingUp:     { threshold = _settings.stage; break; }
+        case State::MovingDown:   { threshold = _settings.stage; break; }
+        case State::Opening:      { threshold = _settings.open;  break; }
+        case State::Idle:         { threshold = _settings.idle;  break; }
+        case State::Closing:      { threshold = _settings.close; break; }
+        case State::Embarking:    { threshold = dwell; break; }
+        case State::Disembarking: { threshold = dwell; break; }
+    }
+    return (threshold > progress) ? threshold - progress : 1;
+}
 // Вспомогательные функции переключения состояния.
 bool Elevator::_switch_closest()
 {
-    // Получение отсортированного по удалённости от лифта множества вызовов.
-    std::set<std::tuple<ssize_t, ssize_t, Direction>> sorted;
-    for (auto iterator = calls.begin(); iterator != calls.end(); ++iterator)
+    // Поиск ближайшего вызова среди всех групп (при равной удалённости - с нижнего этажа, затем по порядку направлений).
+    bool is_found = false;
+    ssize_t best_distance = 0;
+    ssize_t best_floor = 0;
+    Direction best_direction = Direction::None;
+    for (Direction group : { Direction::None, Direction::Upwards, Direction::Downwards })
     {
-        auto after = iterator->second.lower_bound(floor);
-        auto before = after;
-        if (before != iterator->second.begin()) { --before; }
-        else { before = iterator->second.end(); }
-
-        if (after != iterator->second.end())
-        { sorted.insert(std::make_tuple(std::abs(*after - floor), *after, iterator->first)); }
-        if (before != iterator->second.end())
-        { sorted.insert(std::make_tuple(std::abs(*before - floor), *before, iterator->first)); }
+        ssize_t nearest = calls.nearest(_group(group), floor);
+        if (nearest == CallRegistry::none) { continue; }
+
+        ssize_t distance = std::abs(nearest - floor);
+        if (!is_found || (distance < best_distance) || ((distance == best_distance) && (nearest < best_floor)))
+        {
+            is_found = true;
+            best_distance = distance;
+            best_floor = nearest;
+            best_direction = group;
+        }
     }
 
     // Если вызовов нет, продолжается ожидание.
-    if (sorted.empty())
+    if (!is_found)
     { return false; }
 
     // Иначе обрабатывается ближайший вызов.
-    auto top = sorted.begin();
     is_destination_selected = true;
-    destination = std::get<1>(*top);
-    direction = std::get<2>(*top);
+    destination = best_floor;
+    direction = best_direction;
     is_ignoring_other = true;
 
     #ifdef DEBUG_SWITCH_CLOSEST
@@ -329,7 +455,7 @@ bool Elevator::_switch_selected()
     { state = State::MovingDown; }
 
     Outcoming outcoming = _create_outcoming(Outcoming::Code::Departured);
-    outbox.send(outcoming);
+    outgoing.push_back(outcoming);
     return false;
 }
 bool Elevator::_switch_not_selected()
@@ -340,14 +466,13 @@ bool Elevator::_switch_not_selected()
         {
             // Обработка вызова на текущем этаже.
             {
-                auto n_equal = calls[Direction::None].find(floor);
-                if (n_equal != calls[Direction::None].end())
+                if (calls.contains(_group(Direction::None), floor))
                 {
                     is_destination_selected = false;
                     state = State::Opening;
 
                     Outcoming outcoming = _create_outcoming(Outcoming::Code::Arrived);
-                    outbox.send(outcoming);
+                    outgoing.push_back(outcoming);
                     return false;
                 }
             }
@@ -359,40 +484,38 @@ bool Elevator::_switch_not_selected()
         {
             // Обработка вызова на текущем этаже.
             {
-                auto n_equal = calls[Direction::None].find(floor);
-                auto u_equal = calls[Direction::Upwards].find(floor);
-                if ((n_equal != calls[Direction::None].end()) || (u_equal != calls[Direction::Upwards].end()))
+                if (calls.contains(_group(Direction::None), floor) || calls.contains(_group(Direction::Upwards), floor))
                 {
                     is_destination_selected = false;
                     state = State::Opening;
 
                     Outcoming outcoming = _create_outcoming(Outcoming::Code::Arrived);
-                    outbox.send(outcoming);
+                    outgoing.push_back(outcoming);
                     return false;
                 }
             }
 
             // Обработка вызовов с этажей выше.
             {
-                auto u_after = calls[Direction::Upwards].lower_bound(floor);
-                auto n_after = calls[Direction::None].lower_bound(floor);
+                ssize_t u_after = calls.at_or_above(_group(Direction::Upwards), floor);
+                ssize_t n_after = calls.at_or_above(_group(Direction::None), floor);
 
-                if ((u_after != calls[Direction::Upwards].end()) && (n_after != calls[Direction::None].end()))
+                if ((u_after != CallRegistry::none) && (n_after != CallRegistry::none))
                 {
                     is_destination_selected = true;
-                    destination = std::min(*u_after, *n_after);
+                    destination = std::min(u_after, n_after);
                     break;
                 }
-                if (u_after != calls[Direction::Upwards].end())
+                if (u_after != CallRegistry::none)
                 {
                     is_destination_selected = true;
-                    destination = *u_after;
+                    destination = u_after;
                     break;
                 }
-                if (n_after != calls[Direction::None].end())
+                if (n_after != CallRegistry::none)
                 {
                     is_destination_selected = true;
-                    destination = *n_after;
+                    destination = n_after;
                     break;
                 }
             }
@@ -407,44 +530,38 @@ bool Elevator::_switch_not_selected()
         {
             // Обработка вызова на текущем этаже.
             {
-                auto d_equal = calls[Direction::Downwards].find(floor);
-                auto n_equal = calls[Direction::None].find(floor);
-                if ((d_equal != calls[Direction::Downwards].end()) || (n_equal != calls[Direction::None].end()))
+                if (calls.contains(_group(Direction::Downwards), floor) || calls.contains(_group(Direction::None), floor))
                 {
                     is_destination_selected = false;
                     state = State::Opening;
 
                     Outcoming outcoming = _create_outcoming(Outcoming::Code::Arrived);
-                    outbox.send(outcoming);
+                    outgoing.push_back(outcoming);
                     return false;
                 }
             }
 
             // Обработка вызовов с этажей ниже.
             {
-                auto d_before = calls[Direction::Downwards].lower_bound(floor);
-                auto n_before = calls[Direction::None].lower_bound(floor);
-                if (d_before != calls[Direction::Downwards].begin()) { --d_before; }
-                else { d_before = calls[Direction::Downwards].end(); }
-                if (n_before != calls[Direction::None].begin()) { --n_before; }
-                else { n_before = calls[Direction::None].end(); }
-
-                if ((d_before != calls[Direction::Downwards].end()) && (n_before != calls[Direction::None].end()))
+                ssize_t d_before = calls.below(_group(Direction::Downwards), floor);
+                ssize_t n_before = calls.below(_group(Direction::None), floor);
+
+                if ((d_before != CallRegistry::none) && (n_before != CallRegistry::none))
                 {
                     is_destination_selected = true;
-                    destination = std::max(*d_before, *n_before);
+                    destination = std::max(d_before, n_before);
                     break;
                 }
-                if (d_before != calls[Direction::Downwards].end())
+                if (d_before != CallRegistry::none)
                 {
                     is_destination_selected = true;
-                    destination = *d_before;
+                    destination = d_before;
                     break;
                 }
-                if (n_before != calls[Direction::None].end())
+                if (n_before != CallRegistry::none)
                 {
                     is_destination_selected = true;
-                    destination = *n_before;
+                    destination = n_before;
                     break;
                 }
             }
@@ -464,7 +581,7 @@ bool Elevator::_switch_not_selected()
 // Добавить вызов.
 void Elevator::insert_call(ssize_t floor, Direction direction)
 {
-    calls[direction].insert(floor);
+    calls.insert(_group(direction), floor);
     if (!is_ignoring_other)
     { is_destination_selected = false; }
 }
@@ -472,15 +589,15 @@ void Elevator::insert_call(ssize_t floor, Direction direction)
 // Отменить вызов.
 void Elevator::erase_call(ssize_t floor, Direction direction)
 {
-    calls[direction].erase(floor);
+    calls.erase(_group(direction), floor);
     if (floor == destination)
     { is_destination_selected = false; }
 }
 
 Elevator::Outcoming Elevator::_create_outcoming(Outcoming::Code code)
 {
-    Outcoming outcoming = { id_counter++, timestamp, code, state, progress, direction, floor };
-    return std::move(outcoming);
+    Outcoming outcoming = { id_counter++, timestamp, code, state, progress, direction, floor, next_event(), {}, 0, 0 };
+    return outcoming;
 }
 
 // PRIVATE:
@@ -0,0 +1,119 @@
+#include "ElevatorFleet.hpp"
+
+//////////////// ElevatorFleet /////////////////
+// Представление состояния всех лифтов на стороне контроллера в виде структуры массивов.
+// PUBLIC:
+ElevatorFleet::ElevatorFleet(size_t elevators_number)
+{
+    remaining = std::vector<uint32_t>(elevators_number, never);
+    crossed = std::vector<uint8_t>(elevators_number, 0);
+
+    state = std::vector<Elevator::State>(elevators_number, Elevator::State::Waiting);
+    direction = std::vector<Elevator::Direction>(elevators_number, Elevator::Direction::None);
+    floor = std::vector<ssize_t>(elevators_number, 0);
+    progress = std::vector<tick_t>(elevators_number, 0);
+    synchronized = std::vector<tick_t>(elevators_number, 0);
+    load = std::vector<uint64_t>(elevators_number, 0);
+}
+
+size_t ElevatorFleet::size() const
+{
+    return remaining.size();
+}
+
+void ElevatorFleet::update(size_t elevator, const Elevator::Outcoming& outcoming, tick_t timestamp)
+{
+    state[elevator] = outcoming.state;
+    direction[elevator] = outcoming.direction;
+    floor[elevator] = outcoming.floor;
+    progress[elevator] = outcoming.progress;
+    synchronized[elevator] = timestamp;
+
+    // Время до смены состояния ограничивается снизу единицей, а сверху - значением never.
+    if (outcoming.remaining >= never) { remaining[elevator] = never; }
+    else { remaining[elevator] = (outcoming.remaining == 0) ? 1 : static_cast<uint32_t>(outcoming.remaining); }
+}
+void ElevatorFleet::touch(size_t elevator)
+{
+    // Лифт, у которого уже назначена смена состояния, получит вызов вместе с ближайшим тиком: до неё вызов на него не влияет.
+    if (remaining[elevator] == never) { remaining[elevator] = 1; }
+}
+
+tick_t ElevatorFleet::next_event() const
+{
+    const uint32_t* __restrict values = remaining.data();
+    const size_t elevators_number = remaining.size();
+
+    uint32_t result = never;
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator)
+    { result = (values[elevator] < result) ? values[elevator] : result; }
+
+    return (result == never) ? Elevator::never : result;
+}
+void ElevatorFleet::advance(tick_t delta, std::vector<size_t>& due)
+{
+    uint32_t* __restrict values = remaining.data();
+    uint8_t* __restrict flags = crossed.data();
+    const size_t elevators_number = remaining.size();
+
+    // Шаг не превосходит ближайшего события, поэтому для лифтов с конечным remaining он помещается в 32 бита.
+    const uint32_t step = (delta >= never) ? never - 1 : static_cast<uint32_t>(delta);
+
+    // Векторизуемый проход без ветвлений: уменьшение счётчиков и отметка достигших нуля.
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator)
+    {
+        uint32_t value = values[elevator];
+        uint32_t decrement = (value != never) ? step : 0;
+        value = (value > decrement) ? value - decrement : 0;
+        values[elevator] = value;
+        flags[elevator] = (value == 0);
+    }
+
+    // Скалярная обработка только для лифтов, у которых меняется состояние.
+    due.clear();
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator)
+    {
+        if (flags[elevator]) { due.push_back(elevator); }
+    }
+}
+
+tick_t ElevatorFleet::elapsed(size_t elevator, tick_t timestamp) const
+{
+    return timestamp - synchronized[elevator];
+}
+tick_t ElevatorFleet::current_progress(size_t elevator, tick_t timestamp) const
+{
+    // В режиме ожидания прогресс не накапливается.
+    if (state[elevator] == Elevator::State::Waiting) { return 0; }
+    return progress[elevator] + elapsed(elevator, timestamp);
+}
+
+void ElevatorFleet::store(Checkpoint& checkpoint) const
+{
+    checkpoint.write(remaining);
+    checkpoint.write(crossed);
+    checkpoint.write(state);
+    checkpoint.write(direction);
+    checkpoint.write(floor);
+    checkpoint.write(progress);
+    checkpoint.write(synchronized);
+    checkpoint.write(load);
+}
+bool ElevatorFleet::restore(Checkpoint::Reader& reader)
+{
+    const size_t elevators_number = size();
+    bool is_read = reader.read(remaining) && reader.read(crossed) && reader.read(state) && reader.read(direction) &&
+                   reader.read(floor) && reader.read(progress) && reader.read(synchronized) && reader.read(load);
+    if (!is_read) { return false; }
+
+    // Все массивы должны описывать одно и то же число лифтов.
+    for (size_t length : { remaining.size(), crossed.size(), state.size(), direction.size(), floor.size(), progress.size(), synchronized.size(), load.size() })
+    {
+        if (length != elevators_number) { return reader.fail(); }
+    }
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
@@ -0,0 +1,138 @@
+#include "Executor.hpp"
+
+////////////////    Executor    ////////////////
+// Пул рабочих потоков с перехватом задач.
+// PUBLIC:
+Executor::Executor(size_t workers_number, size_t tasks_number, const std::function<void(size_t)>& init_task)
+{
+    task = init_task;
+    task_states.reset(new std::atomic<uint8_t>[tasks_number]);
+    for (size_t index = 0; index < tasks_number; ++index)
+    { task_states[index].store(Idle); }
+
+    // Запуск потоков.
+    if (workers_number == 0) { workers_number = 1; }
+    for (size_t worker = 0; worker < workers_number; ++worker)
+    { workers.emplace_back(new Worker()); }
+    for (size_t worker = 0; worker < workers_number; ++worker)
+    { workers_threads.emplace_back(&Executor::loop, this, worker); }
+}
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_sleeping);
+        working.store(false);
+    }
+    condition_sleeping.notify_all();
+
+    for (size_t worker = 0; worker < workers_threads.size(); ++worker)
+    { workers_threads[worker].join(); }
+}
+
+void Executor::submit(size_t task)
+{
+    uint8_t state = task_states[task].load(std::memory_order_acquire);
+    while (true)
+    {
+        switch (state)
+        {
+            // Задача ставится в очередь "своего" потока, остальные могут её перехватить.
+            case Idle:
+            {
+                if (task_states[task].compare_exchange_weak(state, Scheduled, std::memory_order_acq_rel))
+                {
+                    push(task % workers.size(), task);
+                    return;
+                }
+                break;
+            }
+            // Выполняемая задача будет запущена повторно.
+            case Running:
+            {
+                if (task_states[task].compare_exchange_weak(state, Rescheduled, std::memory_order_acq_rel))
+                { return; }
+                break;
+            }
+            // Задача и так будет выполнена.
+            default: { return; }
+        }
+    }
+}
+size_t Executor::size() const
+{
+    return workers.size();
+}
+
+// PROTECTED:
+void Executor::loop(size_t worker)
+{
+    while (true)
+    {
+        size_t current = 0;
+        if (pop(worker, current))
+        {
+            task_states[current].store(Running, std::memory_order_release);
+            while (true)
+            {
+                task(current);
+
+                // Если за время выполнения задачу запланировали снова, она выполняется ещё раз.
+                uint8_t state = Running;
+                if (task_states[current].compare_exchange_strong(state, Idle, std::memory_order_acq_rel))
+                { break; }
+                task_states[current].store(Running, std::memory_order_release);
+            }
+            continue;
+        }
+
+        // Засыпание до появления задач.
+        std::unique_lock<std::mutex> lock(mutex_sleeping);
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        while (working.load() && (queued.load(std::memory_order_seq_cst) == 0))
+        { condition_sleeping.wait(lock); }
+        sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        if (!working.load()) { return; }
+    }
+}
+void Executor::push(size_t worker, size_t task)
+{
+    // Счётчик увеличивается заранее, чтобы никогда не становиться меньше реального числа задач в очередях.
+    queued.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(workers[worker]->mutex_tasks);
+        workers[worker]->tasks.push_back(task);
+    }
+
+    // Пробуждение потока, если есть спящие.
+    if (sleeping.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex_sleeping);
+        condition_sleeping.notify_one();
+    }
+}
+bool Executor::pop(size_t worker, size_t& task)
+{
+    // Сначала задачи из своей очереди, затем перехват из чужих (с противоположного конца).
+    for (size_t offset = 0; offset < workers.size(); ++offset)
+    {
+        Worker& victim = *workers[(worker + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex_tasks);
+        if (victim.tasks.empty()) { continue; }
+
+        if (offset == 0)
+        {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+        }
+        else
+        {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+        }
+        queued.fetch_sub(1, std::memory_order_seq_cst);
+        return true;
+    }
+    return false;
+}
+
+// PRIVATE:
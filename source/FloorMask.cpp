@@ -0,0 +1,70 @@
+#include "FloorMask.hpp"
+
+#include <cstdlib>
+
+////////////////   FloorMask   /////////////////
+// Множество обслуживаемых этажей.
+// PUBLIC:
+FloorMask::FloorMask(size_t floors_number, bool is_full)
+{
+    floors = floors_number;
+    words = std::vector<uint64_t>((floors + 63) / 64, 0);
+    for (size_t floor = 0; is_full && (floor < floors); ++floor) { insert(floor); }
+}
+
+bool FloorMask::parse(const std::string& specification, size_t floors_number, FloorMask& mask)
+{
+    if (specification == "all")
+    {
+        mask = FloorMask(floors_number);
+        return true;
+    }
+
+    mask = FloorMask(floors_number, false);
+    const char* begin = specification.c_str();
+    char* end = nullptr;
+    while (true)
+    {
+        long lowest = std::strtol(begin, &end, 10);
+        if (end == begin) { return false; }
+        long highest = lowest;
+        if (*end == '-')
+        {
+            begin = end + 1;
+            highest = std::strtol(begin, &end, 10);
+            if (end == begin) { return false; }
+        }
+        if ((lowest < 0) || (lowest > highest) || (static_cast<size_t>(highest) >= floors_number)) { return false; }
+        for (long floor = lowest; floor <= highest; ++floor) { mask.insert(floor); }
+
+        if (*end == '\0') { return true; }
+        if (*end != ',') { return false; }
+        begin = end + 1;
+    }
+}
+
+void FloorMask::insert(ssize_t floor)
+{
+    if ((floor < 0) || (static_cast<size_t>(floor) >= floors)) { return; }
+    words[static_cast<size_t>(floor) >> 6] |= uint64_t(1) << (floor & 63);
+}
+bool FloorMask::full() const
+{
+    for (size_t floor = 0; floor < floors; ++floor)
+    {
+        if (!contains(floor)) { return false; }
+    }
+    return true;
+}
+bool FloorMask::empty() const
+{
+    for (uint64_t word : words)
+    {
+        if (word != 0) { return false; }
+    }
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
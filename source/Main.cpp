@@ -1,16 +1,246 @@
 #include <cinttypes>
 #include <iostream>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include "BinaryTrace.hpp"
 #include "Controller.hpp"
+#include "FloorMask.hpp"
+#include "Parsing.hpp"
+#include "Sweep.hpp"
+#include "Tower.hpp"
+#include "TrafficGenerator.hpp"
 
 //#define DEBUG_SETTINGS
 
-int main()
+// Вывод справки по аргументам командной строки.
+void print_usage(const char* name)
+{
+    std::cerr << "Использование: " << name << " [--batch] [--event-driven] [--workers <число>] [--dispatch | --destination [--sectors <число>]] [--bulk] [--fps <число>] [--report <тики>] [--window <тики>] [--trace <файл>] [--generate <профиль> [--rate <число>] [--duration <тики>] [--seed <число>] [--limit <число>]] [--sweep <параметр>=<значения> ... [--jobs <число>]] [--pause-at <тики> --checkpoint <файл>] [--restore <файл>] [--zones <зоны> [--epoch <тики>]] [--cars <файл>] [--input <файл>]" << std::endl
+              << "       " << name << " --convert <текстовая трасса> <двоичная трасса>" << std::endl
+              << "  --batch          пакетный режим: без отрисовки и задержек, со сводкой в конце прогона;" << std::endl
+              << "  --event-driven   переход сразу к ближайшему событию (прибытию человека или смене состояния лифта) вместо единичных тиков;" << std::endl
+              << "  --workers <число> выполнение лифтов в пуле из заданного числа потоков (0 - по числу ядер) вместо потока на каждый лифт;" << std::endl
+              << "  --dispatch       назначение каждого вызова с этажа одному лифту с наименьшим оценочным временем прибытия вместо рассылки всем лифтам;" << std::endl
+              << "  --destination    назначение по пунктам назначения: ожидающие на этаже делятся на группы по секторам этажей назначения," << std::endl
+              << "                   каждая группа назначается одному лифту, и лифт забирает с этажа только назначенные ему группы;" << std::endl
+              << "  --sectors <число> число секторов этажей назначения (по умолчанию этажей в секторе примерно столько, сколько мест в лифте);" << std::endl
+              << "  --bulk           выход и посадка всех людей на остановке одним обменом сообщениями с лифтом вместо обмена на каждого человека;" << std::endl
+              << "  --fps <число>    предельная частота кадров отрисовки в интерактивном режиме;" << std::endl
+              << "  --report <тики>  промежуточный вывод показателей в пакетном режиме с заданным интервалом;" << std::endl
+              << "  --window <тики>  окно подсчёта пропускной способности (по умолчанию 100);" << std::endl
+              << "  --trace <файл>   запись трассы выполнения в формате Chrome Trace (при сборке с ELEVATORS_TRACE);" << std::endl
+              << "  --generate <профиль> в пакетном режиме вместо трассы порождать прибытия: uniform, up-peak, down-peak или lunch;" << std::endl
+              << "  --rate <число>   наибольшая интенсивность прибытий, людей за тик (по умолчанию 0.1);" << std::endl
+              << "  --duration <тики> длительность потока прибытий (по умолчанию 10000);" << std::endl
+              << "  --seed <число>   зерно генератора (по умолчанию 1);" << std::endl
+              << "  --limit <число>  наибольшее число людей (по умолчанию без ограничения);" << std::endl
+              << "  --sweep <параметр>=<значения> перебор значений параметра (elevators, capacity, stage, open, idle, close, in, out)" << std::endl
+              << "                   списком a,b,c или диапазоном от:до[:шаг]; прогоны всех сочетаний выполняются одновременно" << std::endl
+              << "                   на одной трассе, результаты выводятся таблицей (только в пакетном режиме);" << std::endl
+              << "  --jobs <число>   число одновременных прогонов при переборе (0 - по числу ядер);" << std::endl
+              << "  --pause-at <тики> остановка пакетного прогона в заданный момент времени;" << std::endl
+              << "  --checkpoint <файл> запись контрольной точки в момент остановки;" << std::endl
+              << "  --restore <файл> продолжение прогона с контрольной точки (на той же трассе; параметры лифтов можно изменить," << std::endl
+              << "                   а с --sweep - перебрать, ответвив от точки несколько прогонов);" << std::endl
+              << "  --zones <зоны>   многозонная модель: зоны \"нижний-верхний:лифты,...\" снизу вверх с общими этажами пересадки," << std::endl
+              << "                   каждая зона моделируется своим контроллером в отдельном потоке (только в пакетном режиме);" << std::endl
+              << "  --epoch <тики>   длина эпохи синхронизации зон (по умолчанию 10): пересадки передаются в начале следующей эпохи;" << std::endl
+              << "  --cars <файл>    разнородные лифты: строки \"число этажи [вместимость этап открытие ожидание закрытие вход выход]\"," << std::endl
+              << "                   где этажи - all или список этажей и диапазонов (\"0,40-59\"), а опущенные параметры берутся" << std::endl
+              << "                   из параметров модели; сумма чисел лифтов должна совпадать с параметрами модели;" << std::endl
+              << "  --input <файл>   чтение параметров модели и трассы прибытий из файла вместо стандартного ввода" << std::endl
+              << "                   (двоичная трасса распознаётся автоматически и читается только в пакетном режиме);" << std::endl
+              << "  --convert        преобразование текстовой трассы в двоичную и выход." << std::endl;
+}
+
+// Чтение описания разнородных лифтов: по строке на набор одинаковых лифтов.
+bool read_cars(const std::string& path, size_t floors_number, const Elevator::Settings& default_settings,
+               std::vector<Elevator::Settings>& settings, std::vector<FloorMask>& masks)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cerr << "Не удалось открыть файл " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number)
+    {
+        std::istringstream stream(line);
+        size_t count = 0;
+        std::string floors;
+        if (!(stream >> count))
+        {
+            // Пустые строки пропускаются.
+            if (line.find_first_not_of(" \t\r") == std::string::npos) { continue; }
+            std::cerr << "Некорректное описание лифтов в строке " << line_number << " файла " << path << std::endl;
+            return false;
+        }
+
+        // Опущенные в конце строки параметры берутся из параметров модели.
+        Elevator::Settings car = default_settings;
+        FloorMask mask;
+        bool is_valid = (stream >> floors) && FloorMask::parse(floors, floors_number, mask);
+        std::string field;
+        for (uint64_t* value : { &car.capacity, &car.stage, &car.open, &car.idle, &car.close, &car.in, &car.out })
+        {
+            if (!is_valid || !(stream >> field)) { break; }
+            is_valid = parse_number(field.c_str(), *value);
+        }
+        // Лифт без мест или без обслуживаемых этажей никого не доставит, и прогон не завершился бы.
+        if (!is_valid || (stream >> field) || (car.capacity == 0) || mask.empty())
+        {
+            std::cerr << "Некорректное описание лифтов в строке " << line_number << " файла " << path << std::endl;
+            return false;
+        }
+
+        settings.insert(settings.end(), count, car);
+        masks.insert(masks.end(), count, mask);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
 {
     Elevator::Settings default_settings;
     size_t floors_number = 0;
     size_t elevators_number = 0;
 
+    // Разбор аргументов командной строки.
+    Controller::Options options;
+    std::string input_path;
+    std::string trace_path;
+    std::string profile_name;
+    double rate = 0.1;
+    tick_t duration = 10000;
+    uint64_t seed = 1;
+    uint64_t limit = 0;
+    std::vector<std::string> sweep_specifications;
+    size_t jobs = 0;
+    std::string checkpoint_path;
+    std::string restore_path;
+    std::string zones_specification;
+    tick_t epoch = 10;
+    std::string cars_path;
+    for (int argument = 1; argument < argc; ++argument)
+    {
+        std::string value = argv[argument];
+        bool is_number = true; // Удалось ли разобрать числовое значение аргумента.
+        if (value == "--batch") { options.interactive = false; }
+        else if (value == "--event-driven") { options.event_driven = true; }
+        else if ((value == "--workers") && (argument + 1 < argc))
+        {
+            options.pooled = true;
+            is_number = parse_number(argv[++argument], options.workers);
+        }
+        else if (value == "--dispatch") { options.dispatched = true; }
+        else if (value == "--destination") { options.destination = true; }
+        else if ((value == "--sectors") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], options.sectors); }
+        else if (value == "--bulk") { options.bulk = true; }
+        else if ((value == "--fps") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], options.frame_rate); }
+        else if ((value == "--report") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], options.report_interval); }
+        else if ((value == "--window") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], options.window); }
+        else if ((value == "--trace") && (argument + 1 < argc)) { trace_path = argv[++argument]; }
+        else if ((value == "--generate") && (argument + 1 < argc)) { profile_name = argv[++argument]; }
+        else if ((value == "--rate") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], rate); }
+        else if ((value == "--duration") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], duration); }
+        else if ((value == "--seed") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], seed); }
+        else if ((value == "--limit") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], limit); }
+        else if ((value == "--sweep") && (argument + 1 < argc)) { sweep_specifications.push_back(argv[++argument]); }
+        else if ((value == "--jobs") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], jobs); }
+        else if ((value == "--pause-at") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], options.pause_at); }
+        else if ((value == "--checkpoint") && (argument + 1 < argc)) { checkpoint_path = argv[++argument]; }
+        else if ((value == "--restore") && (argument + 1 < argc)) { restore_path = argv[++argument]; }
+        else if ((value == "--zones") && (argument + 1 < argc)) { zones_specification = argv[++argument]; }
+        else if ((value == "--epoch") && (argument + 1 < argc)) { is_number = parse_number(argv[++argument], epoch); }
+        else if ((value == "--cars") && (argument + 1 < argc)) { cars_path = argv[++argument]; }
+        else if ((value == "--input") && (argument + 1 < argc)) { input_path = argv[++argument]; }
+        else if ((value == "--convert") && (argument + 2 < argc))
+        {
+            std::ifstream text_file(argv[argument + 1]);
+            if (!text_file)
+            {
+                std::cerr << "Не удалось открыть файл " << argv[argument + 1] << std::endl;
+                return 1;
+            }
+            return BinaryTrace::convert(text_file, argv[argument + 2]) ? 0 : 1;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        if (!is_number)
+        {
+            std::cerr << "Некорректное значение аргумента " << value << ": " << argv[argument] << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.dispatched && options.destination)
+    {
+        std::cerr << "Назначение вызовов по направлению (--dispatch) и по пунктам назначения (--destination) несовместимы." << std::endl;
+        return 1;
+    }
+    if (!profile_name.empty() && options.interactive)
+    {
+        std::cerr << "Генерация прибытий доступна только в пакетном режиме." << std::endl;
+        return 1;
+    }
+    if (!sweep_specifications.empty() && options.interactive)
+    {
+        std::cerr << "Перебор параметров доступен только в пакетном режиме." << std::endl;
+        return 1;
+    }
+    if ((!checkpoint_path.empty() || !restore_path.empty()) && options.interactive)
+    {
+        std::cerr << "Контрольные точки доступны только в пакетном режиме." << std::endl;
+        return 1;
+    }
+    if (!zones_specification.empty() && (options.interactive || !sweep_specifications.empty() || !checkpoint_path.empty() || !restore_path.empty()))
+    {
+        std::cerr << "Многозонная модель доступна только в пакетном режиме без перебора параметров и контрольных точек." << std::endl;
+        return 1;
+    }
+    if (!cars_path.empty() && (!zones_specification.empty() || !sweep_specifications.empty()))
+    {
+        std::cerr << "Разнородные лифты несовместимы с многозонной моделью и перебором параметров." << std::endl;
+        return 1;
+    }
+
+    // Двоичная трасса содержит параметры модели в заголовке и читается через отображение в память.
+    BinaryArrivals binary_arrivals;
+    bool is_binary = !input_path.empty() && BinaryTrace::probe(input_path);
+    if (is_binary)
+    {
+        if (options.interactive || !profile_name.empty())
+        {
+            std::cerr << "Двоичная трасса читается только в пакетном режиме без генерации прибытий." << std::endl;
+            return 1;
+        }
+        if (!binary_arrivals.open(input_path)) { return 1; }
+    }
+
+    // Источник входных данных.
+    std::ifstream input_file;
+    if (!input_path.empty() && !is_binary)
+    {
+        input_file.open(input_path);
+        if (!input_file)
+        {
+            std::cerr << "Не удалось открыть файл " << input_path << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = input_path.empty() ? std::cin : input_file;
+
     #ifdef DEBUG_SETTINGS
     floors_number = 10;
     elevators_number = 10;
@@ -24,19 +254,161 @@ int main()
     #endif
 
     #ifndef DEBUG_SETTINGS
-    std::cout << "\033[2J\033[1;1H"; // Очистка экрана.
-    std::cout << "Введите параметры модели: ";
-    std::cin >> floors_number >> elevators_number
-             >> default_settings.capacity
-             >> default_settings.stage
-             >> default_settings.open
-             >> default_settings.idle
-             >> default_settings.close
-             >> default_settings.in
-             >> default_settings.out;
+    if (is_binary)
+    {
+        floors_number = binary_arrivals.header().floors_number;
+        elevators_number = binary_arrivals.header().elevators_number;
+        default_settings = binary_arrivals.settings();
+    }
+    else
+    {
+        if (options.interactive)
+        {
+            std::cout << "\033[2J\033[1;1H"; // Очистка экрана.
+            std::cout << "Введите параметры модели: ";
+        }
+        input >> floors_number >> elevators_number
+              >> default_settings.capacity
+              >> default_settings.stage
+              >> default_settings.open
+              >> default_settings.idle
+              >> default_settings.close
+              >> default_settings.in
+              >> default_settings.out;
+        if (!input)
+        {
+            std::cerr << "Некорректные параметры модели." << std::endl;
+            return 1;
+        }
+    }
     #endif
 
-    Controller controller(floors_number, elevators_number, default_settings);
-    controller.loop();
+    // Без лифтов, мест в них или хотя бы двух этажей никого нельзя доставить, и прогон не завершился бы.
+    if ((floors_number < 2) || (elevators_number == 0) || (default_settings.capacity == 0))
+    {
+        std::cerr << "Некорректные параметры модели." << std::endl;
+        return 1;
+    }
+
+    // Разнородные лифты: без описания все лифты одинаковы и обслуживают все этажи.
+    std::vector<Elevator::Settings> cars_settings;
+    std::vector<FloorMask> cars_masks;
+    if (!cars_path.empty())
+    {
+        if (!read_cars(cars_path, floors_number, default_settings, cars_settings, cars_masks)) { return 1; }
+        if (cars_settings.size() != elevators_number)
+        {
+            std::cerr << "Число лифтов в описании (" << cars_settings.size() << ") не совпадает с параметрами модели (" << elevators_number << ")." << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        cars_settings = std::vector<Elevator::Settings>(elevators_number, default_settings);
+        cars_masks = std::vector<FloorMask>(elevators_number, FloorMask(floors_number));
+    }
+
+    // Прибытия порождаются генератором и передаются контроллеру напрямую.
+    std::unique_ptr<TrafficGenerator> generator;
+    if (!profile_name.empty())
+    {
+        TrafficGenerator::Profile profile;
+        if (!TrafficGenerator::preset(profile_name, floors_number, rate, duration, profile))
+        {
+            std::cerr << "Неизвестный профиль " << profile_name << std::endl;
+            return 1;
+        }
+        generator.reset(new TrafficGenerator(profile, duration, seed, limit));
+    }
+    TraceArrivals text_arrivals(input);
+    Arrivals* arrivals = &text_arrivals;
+    if (is_binary) { arrivals = &binary_arrivals; }
+    else if (generator) { arrivals = generator.get(); }
+
+    // Контрольная точка, с которой продолжается прогон: числа этажей и лифтов должны совпадать с моделью,
+    // а параметры лифтов берутся из входных данных.
+    Checkpoint origin;
+    if (!restore_path.empty())
+    {
+        if (!origin.load(restore_path)) { return 1; }
+        size_t origin_floors = 0;
+        size_t origin_elevators = 0;
+        if (!Controller::describe(origin, origin_floors, origin_elevators) ||
+            (origin_floors != floors_number) || (origin_elevators != elevators_number))
+        {
+            std::cerr << "Контрольная точка " << restore_path << " не соответствует параметрам модели." << std::endl;
+            return 1;
+        }
+    }
+
+    // Многозонная модель: число лифтов задаётся зонами и должно совпадать с параметрами модели.
+    if (!zones_specification.empty())
+    {
+        std::vector<Tower::Zone> zones;
+        if (!Tower::parse(zones_specification, floors_number, zones)) { return 1; }
+        size_t zones_elevators = 0;
+        for (size_t zone = 0; zone < zones.size(); ++zone) { zones_elevators += zones[zone].elevators_number; }
+        if (zones_elevators != elevators_number)
+        {
+            std::cerr << "Число лифтов в зонах (" << zones_elevators << ") не совпадает с параметрами модели (" << elevators_number << ")." << std::endl;
+            return 1;
+        }
+
+        Tower tower(zones, default_settings, options, epoch);
+        tower.run(*arrivals);
+        tower.print_summary(std::cout);
+    }
+    // Перебор параметров: трасса читается в память один раз и воспроизводится всеми прогонами.
+    else if (!sweep_specifications.empty())
+    {
+        Sweep::Parameters base;
+        base.elevators_number = elevators_number;
+        base.settings = default_settings;
+        Sweep sweep(floors_number, base, options);
+        for (size_t specification = 0; specification < sweep_specifications.size(); ++specification)
+        {
+            if (!sweep.vary(sweep_specifications[specification])) { return 1; }
+        }
+
+        if (!restore_path.empty()) { sweep.fork(&origin); }
+
+        std::vector<Person> persons;
+        ReplayArrivals::load(*arrivals, persons);
+        if (!sweep.run(persons, jobs)) { return 1; }
+        sweep.print(std::cout);
+    }
+    else
+    {
+        Controller controller(floors_number, cars_settings, cars_masks, options);
+        if (options.interactive) { controller.loop(input); }
+        else
+        {
+            if (!restore_path.empty() && !controller.restore(origin))
+            {
+                std::cerr << "Контрольная точка " << restore_path << " повреждена." << std::endl;
+                return 1;
+            }
+
+            // Прогон, остановленный в момент pause_at, сохраняется в контрольную точку.
+            if (!controller.run(*arrivals) && !checkpoint_path.empty())
+            {
+                Checkpoint checkpoint;
+                controller.checkpoint(checkpoint);
+                if (!checkpoint.save(checkpoint_path)) { return 1; }
+            }
+            controller.print_summary(std::cout);
+        }
+    }
+
+    // Трасса выводится после остановки всех потоков лифтов.
+    if (!trace_path.empty())
+    {
+        #ifdef TRACE
+        std::ofstream trace_file(trace_path);
+        TRACE_DUMP(trace_file);
+        #else
+        std::cerr << "Трассировка отключена при сборке (ELEVATORS_TRACE)." << std::endl;
+        #endif
+    }
     return 0;
 }
@@ -0,0 +1,150 @@
+#include "Metrics.hpp"
+
+static const char* state_names[] = { "waiting", "moving_up", "moving_down", "opening", "idle", "closing", "embarking", "disembarking" };
+
+////////////////    Metrics    /////////////////
+// Потоковые показатели прогона.
+// PUBLIC:
+Metrics::Metrics(size_t elevators_number, tick_t init_window)
+{
+    window = init_window ? init_window : 1;
+    state_ticks = std::vector<tick_t>(elevators_number * states_number, 0);
+    states = std::vector<Elevator::State>(elevators_number, Elevator::State::Waiting);
+    states_since = std::vector<tick_t>(elevators_number, 0);
+    stops_counts = std::vector<uint64_t>(elevators_number, 0);
+}
+
+void Metrics::boarded(const Person& person)
+{
+    wait_times.record(person.boarded - person.timestamp);
+}
+void Metrics::alighted(const Person& person)
+{
+    ride_times.record(person.alighted - person.boarded);
+
+    // Завершённые окна (в том числе пустые) учитываются при переходе в новое окно.
+    uint64_t index = person.alighted / window;
+    if (index > window_index)
+    {
+        window_counts.record(window_count);
+        window_counts.record(0, index - window_index - 1);
+        window_index = index;
+        window_count = 0;
+    }
+    ++window_count;
+}
+void Metrics::state(size_t elevator, Elevator::State state, tick_t timestamp)
+{
+    if (states[elevator] == state) { return; }
+    state_ticks[elevator * states_number + static_cast<size_t>(states[elevator])] += timestamp - states_since[elevator];
+    states[elevator] = state;
+    states_since[elevator] = timestamp;
+}
+void Metrics::stopped(size_t elevator, uint64_t passing)
+{
+    ++stops_counts[elevator];
+    passing_count += passing;
+}
+
+void Metrics::print(std::ostream& output, tick_t timestamp) const
+{
+    output << "{\"wait\": ";
+    print_histogram(output, wait_times);
+    output << ", \"ride\": ";
+    print_histogram(output, ride_times);
+
+    output << ", \"throughput\": {\"window\": " << window
+           << ", \"windows\": " << window_counts.count()
+           << ", \"mean\": " << window_counts.mean()
+           << ", \"max\": " << window_counts.max()
+           << ", \"current\": " << window_count << "}";
+
+    output << ", \"stops\": {\"total\": " << stops()
+           << ", \"per_ride\": " << stops_per_ride() << "}";
+
+    // Доли времени в состояниях для каждого лифта с учётом незавершённого пребывания в текущем состоянии.
+    const size_t elevators_number = states.size();
+    std::vector<double> fleet_shares(states_number, 0.0);
+    output << ", \"utilization\": [";
+    for (size_t elevator = 0; elevator < elevators_number; ++elevator)
+    {
+        output << (elevator ? ", " : "") << "{";
+        for (size_t state = 0; state < states_number; ++state)
+        {
+            double elevator_share = share(elevator, static_cast<Elevator::State>(state), timestamp);
+            fleet_shares[state] += elevator_share / elevators_number;
+            output << (state ? ", " : "") << "\"" << state_names[state] << "\": " << elevator_share;
+        }
+        output << "}";
+    }
+    output << "], \"fleet\": {";
+    for (size_t state = 0; state < states_number; ++state)
+    { output << (state ? ", " : "") << "\"" << state_names[state] << "\": " << fleet_shares[state]; }
+    output << "}}";
+}
+
+double Metrics::share(size_t elevator, Elevator::State state, tick_t timestamp) const
+{
+    // Учитывается и незавершённое пребывание в текущем состоянии.
+    tick_t ticks = state_ticks[elevator * states_number + static_cast<size_t>(state)];
+    if (states[elevator] == state) { ticks += timestamp - states_since[elevator]; }
+    return timestamp ? static_cast<double>(ticks) / timestamp : 0.0;
+}
+double Metrics::fleet_share(Elevator::State state, tick_t timestamp) const
+{
+    double result = 0.0;
+    for (size_t elevator = 0; elevator < states.size(); ++elevator)
+    { result += share(elevator, state, timestamp) / states.size(); }
+    return result;
+}
+uint64_t Metrics::stops() const
+{
+    uint64_t result = 0;
+    for (size_t elevator = 0; elevator < stops_counts.size(); ++elevator) { result += stops_counts[elevator]; }
+    return result;
+}
+double Metrics::stops_per_ride() const
+{
+    // Промежуточные остановки учтены при остановках лифтов (включая остановки ещё едущих пассажиров) и делятся на число завершённых поездок.
+    return ride_times.count() ? static_cast<double>(passing_count) / ride_times.count() : 0.0;
+}
+
+void Metrics::store(Checkpoint& checkpoint) const
+{
+    wait_times.store(checkpoint);
+    ride_times.store(checkpoint);
+    checkpoint.write(window);
+    checkpoint.write(window_index);
+    checkpoint.write(window_count);
+    window_counts.store(checkpoint);
+    checkpoint.write(state_ticks);
+    checkpoint.write(states);
+    checkpoint.write(states_since);
+    checkpoint.write(stops_counts);
+    checkpoint.write(passing_count);
+}
+bool Metrics::restore(Checkpoint::Reader& reader)
+{
+    bool is_read = wait_times.restore(reader) && ride_times.restore(reader) &&
+                   reader.read(window) && reader.read(window_index) && reader.read(window_count) && window_counts.restore(reader) &&
+                   reader.read(state_ticks) && reader.read(states) && reader.read(states_since) &&
+                   reader.read(stops_counts) && reader.read(passing_count);
+    if (!is_read) { return false; }
+    if ((window == 0) || (states_since.size() != states.size()) || (state_ticks.size() != states.size() * states_number) ||
+        (stops_counts.size() != states.size()))
+    { return reader.fail(); }
+    return true;
+}
+
+// PROTECTED:
+void Metrics::print_histogram(std::ostream& output, const Histogram& histogram)
+{
+    output << "{\"count\": " << histogram.count()
+           << ", \"mean\": " << histogram.mean()
+           << ", \"p50\": " << histogram.percentile(50)
+           << ", \"p90\": " << histogram.percentile(90)
+           << ", \"p99\": " << histogram.percentile(99)
+           << ", \"max\": " << histogram.max() << "}";
+}
+
+// PRIVATE:
@@ -0,0 +1,105 @@
+#include "PassengerQueues.hpp"
+
+//////////////// PassengerQueues ////////////////
+// Очереди ожидающих людей на этажах.
+// PUBLIC:
+PassengerQueues::PassengerQueues(size_t floors_number)
+{
+    queues = std::vector<Queue>(2 * floors_number);
+}
+
+size_t PassengerQueues::floors() const
+{
+    return queues.size() / 2;
+}
+size_t PassengerQueues::size() const
+{
+    return waiting;
+}
+size_t PassengerQueues::size(ssize_t floor, Elevator::Direction direction) const
+{
+    return queue(floor, direction).size;
+}
+
+uint32_t PassengerQueues::push(const Person& person, Elevator::Direction direction)
+{
+    // Запись берётся из списка свободных, а при его отсутствии пул расширяется.
+    uint32_t index = free_head;
+    if (index != end) { free_head = records[index].next; }
+    else
+    {
+        index = static_cast<uint32_t>(records.size());
+        records.emplace_back();
+    }
+    records[index] = {person.timestamp, static_cast<uint32_t>(person.destination), static_cast<int32_t>(person.final_destination), end, -1};
+
+    Queue& current = queue(person.origin, direction);
+    if (current.tail == end) { current.head = index; }
+    else { records[current.tail].next = index; }
+    current.tail = index;
+    ++current.size;
+    ++waiting;
+    return index;
+}
+Person PassengerQueues::front(ssize_t floor, Elevator::Direction direction) const
+{
+    return person(floor, queue(floor, direction).head);
+}
+void PassengerQueues::pop(ssize_t floor, Elevator::Direction direction)
+{
+    erase(floor, direction, queue(floor, direction).head, end);
+}
+Person PassengerQueues::person(ssize_t floor, uint32_t record) const
+{
+    const Record& current = records[record];
+    Person result = {current.timestamp, floor, static_cast<ssize_t>(current.destination)};
+    result.final_destination = current.final_destination;
+    return result;
+}
+void PassengerQueues::erase(ssize_t floor, Elevator::Direction direction, uint32_t index, uint32_t previous)
+{
+    Queue& current = queue(floor, direction);
+    if (index == end) { return; }
+
+    // Запись исключается из цепочки очереди.
+    if (previous == end) { current.head = records[index].next; }
+    else { records[previous].next = records[index].next; }
+    if (current.tail == index) { current.tail = previous; }
+    --current.size;
+    --waiting;
+
+    // Освобождённая запись возвращается в список свободных.
+    records[index].next = free_head;
+    free_head = index;
+}
+
+void PassengerQueues::store(Checkpoint& checkpoint) const
+{
+    checkpoint.write(queues);
+    checkpoint.write(records);
+    checkpoint.write(free_head);
+    checkpoint.write<uint64_t>(waiting);
+}
+bool PassengerQueues::restore(Checkpoint::Reader& reader)
+{
+    uint64_t waiting_number = 0;
+    if (!reader.read(queues) || !reader.read(records) || !reader.read(free_head) || !reader.read(waiting_number)) { return false; }
+    waiting = waiting_number;
+
+    // Связи должны указывать на записи пула.
+    if ((queues.size() % 2 != 0) || ((free_head != end) && (free_head >= records.size()))) { return reader.fail(); }
+    for (size_t index = 0; index < queues.size(); ++index)
+    {
+        if ((queues[index].head != end) && ((queues[index].head >= records.size()) || (queues[index].tail >= records.size())))
+        { return reader.fail(); }
+    }
+    for (size_t index = 0; index < records.size(); ++index)
+    {
+        if ((records[index].next != end) && (records[index].next >= records.size())) { return reader.fail(); }
+    }
+    return true;
+}
+
+// PROTECTED:
+
+// PRIVATE:
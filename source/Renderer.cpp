@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "Renderer.hpp"
+
+// Позиция начала символа UTF-8, не превосходящая заданной.
+static size_t _character_start(const std::string& line, size_t position)
+{
+    while ((position > 0) && (position < line.size()) && ((static_cast<unsigned char>(line[position]) & 0xC0) == 0x80))
+    { --position; }
+    return position;
+}
+// Номер столбца терминала (с единицы) для позиции в строке UTF-8.
+static size_t _column(const std::string& line, size_t position)
+{
+    size_t column = 1;
+    for (size_t index = 0; index < position; ++index)
+    { column += ((static_cast<unsigned char>(line[index]) & 0xC0) != 0x80); }
+    return column;
+}
+
+////////////////    Renderer    ////////////////
+// Отрисовка модели в терминале в отдельном потоке.
+// PUBLIC:
+Renderer::Renderer(std::ostream& init_output, size_t frame_rate) : output(init_output)
+{
+    if (frame_rate == 0) { frame_rate = 1; }
+    period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / frame_rate));
+    thread = std::thread(&Renderer::loop, this);
+}
+Renderer::~Renderer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_frame);
+        working = false;
+    }
+    condition_frame.notify_all();
+    thread.join();
+
+    // Отрисовка последнего опубликованного кадра и перевод курсора под него.
+    std::lock_guard<std::mutex> lock(mutex_output);
+    buffer.clear();
+    if (is_pending) { draw(pending); }
+    buffer += "\033[" + std::to_string(rows.load() + 2) + ";1H\033[K";
+    output.write(buffer.data(), buffer.size());
+    output.flush();
+}
+
+bool Renderer::requested() const
+{
+    return is_requested.load(std::memory_order_relaxed);
+}
+void Renderer::publish(Frame& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_frame);
+        pending.swap(frame);
+        is_pending = true;
+        rows = std::max(rows.load(std::memory_order_relaxed), pending.size());
+        is_requested.store(false, std::memory_order_relaxed);
+    }
+    condition_frame.notify_one();
+}
+void Renderer::prompt(const std::string& text)
+{
+    std::lock_guard<std::mutex> lock(mutex_output);
+    buffer = "\033[" + std::to_string(rows.load() + 2) + ";1H\033[K" + text;
+    output.write(buffer.data(), buffer.size());
+    output.flush();
+}
+
+// PROTECTED:
+void Renderer::loop()
+{
+    Frame frame;
+    auto next = std::chrono::steady_clock::now();
+    while (true)
+    {
+        // Ожидание опубликованного кадра.
+        {
+            std::unique_lock<std::mutex> lock(mutex_frame);
+            is_requested.store(true, std::memory_order_relaxed);
+            condition_frame.wait(lock, [this]() { return is_pending || !working; });
+            if (!working) { return; }
+            frame.swap(pending);
+            is_pending = false;
+        }
+
+        // Вывод отличий с сохранением позиции курсора (приглашения ввода).
+        {
+            std::lock_guard<std::mutex> lock(mutex_output);
+            buffer = "\0337";
+            draw(frame);
+            buffer += "\0338";
+            output.write(buffer.data(), buffer.size());
+            output.flush();
+        }
+
+        // Ограничение частоты кадров.
+        next += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) { next = now; }
+        else { std::this_thread::sleep_until(next); }
+    }
+}
+void Renderer::draw(const Frame& frame)
+{
+    if (!is_cleared)
+    {
+        buffer += "\033[2J";
+        is_cleared = true;
+    }
+
+    for (size_t row = 0; row < frame.size(); ++row)
+    {
+        const std::string& line = frame[row];
+        const std::string empty;
+        const std::string& previous = (row < displayed.size()) ? displayed[row] : empty;
+        if (line == previous) { continue; }
+
+        // Общее начало строк пропускается.
+        size_t begin = 0;
+        while ((begin < line.size()) && (begin < previous.size()) && (line[begin] == previous[begin])) { ++begin; }
+        begin = _character_start(line, begin);
+
+        // При равной длине пропускается и общий конец, иначе хвост строки переписывается целиком.
+        size_t end = line.size();
+        if (line.size() == previous.size())
+        {
+            while ((end > begin) && (line[end - 1] == previous[end - 1])) { --end; }
+            while ((end < line.size()) && ((static_cast<unsigned char>(line[end]) & 0xC0) == 0x80)) { ++end; }
+        }
+
+        buffer += "\033[" + std::to_string(row + 1) + ";" + std::to_string(_column(line, begin)) + "H";
+        buffer.append(line, begin, end - begin);
+        if (line.size() != previous.size()) { buffer += "\033[K"; }
+    }
+
+    // Строки, которых нет в новом кадре, стираются.
+    for (size_t row = frame.size(); row < displayed.size(); ++row)
+    { buffer += "\033[" + std::to_string(row + 1) + ";1H\033[K"; }
+
+    displayed = frame;
+}
+
+// PRIVATE:
@@ -0,0 +1,205 @@
+#include "Sweep.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+const std::vector<std::string> Sweep::names = { "elevators", "capacity", "stage", "open", "idle", "close", "in", "out" };
+
+////////////////     Sweep     /////////////////
+// Перебор параметров модели.
+// PUBLIC:
+Sweep::Sweep(size_t init_floors_number, const Parameters& init_base, const Controller::Options& init_options)
+{
+    floors_number = init_floors_number;
+    base = init_base;
+    values = std::vector<std::vector<uint64_t>>(names.size());
+
+    // Прогоны пакетные и без промежуточного вывода. Чтобы одновременные прогоны не порождали по потоку на каждый лифт,
+    // лифты каждого прогона по умолчанию выполняются в пуле из одного потока.
+    options = init_options;
+    options.interactive = false;
+    options.report_interval = 0;
+    if (!options.pooled)
+    {
+        options.pooled = true;
+        options.workers = 1;
+    }
+}
+
+bool Sweep::vary(const std::string& specification, std::ostream& errors)
+{
+    size_t separator = specification.find('=');
+    size_t parameter = std::find(names.begin(), names.end(), specification.substr(0, separator)) - names.begin();
+    if ((separator == std::string::npos) || (parameter == names.size()))
+    {
+        errors << "Некорректный параметр перебора: " << specification << std::endl;
+        return false;
+    }
+
+    // Разбор списка значений или диапазона.
+    std::vector<uint64_t> parsed;
+    const char* begin = specification.c_str() + separator + 1;
+    char* end = nullptr;
+    bool is_valid = true;
+    if (specification.find(':', separator) != std::string::npos)
+    {
+        uint64_t from = std::strtoull(begin, &end, 10);
+        is_valid = is_valid && (end != begin) && (*end == ':');
+        begin = end + 1;
+        uint64_t to = std::strtoull(begin, &end, 10);
+        is_valid = is_valid && (end != begin);
+        uint64_t step = 1;
+        if (is_valid && (*end == ':'))
+        {
+            begin = end + 1;
+            step = std::strtoull(begin, &end, 10);
+            is_valid = (end != begin);
+        }
+        is_valid = is_valid && (*end == '\0') && (step > 0) && (from <= to);
+        for (uint64_t value = from; is_valid && (value <= to); value += step) { parsed.push_back(value); }
+    }
+    else
+    {
+        while (is_valid)
+        {
+            parsed.push_back(std::strtoull(begin, &end, 10));
+            is_valid = (end != begin) && ((*end == ',') || (*end == '\0'));
+            if (*end != ',') { break; }
+            begin = end + 1;
+        }
+    }
+
+    // Лифтов и мест в лифте должно быть хотя бы по одному.
+    if (is_valid && (parameter <= 1)) { is_valid = std::find(parsed.begin(), parsed.end(), 0) == parsed.end(); }
+    if (!is_valid || parsed.empty())
+    {
+        errors << "Некорректные значения параметра перебора: " << specification << std::endl;
+        return false;
+    }
+    values[parameter] = parsed;
+    return true;
+}
+size_t Sweep::size() const
+{
+    size_t result = 1;
+    for (size_t parameter = 0; parameter < values.size(); ++parameter)
+    { result *= std::max<size_t>(1, values[parameter].size()); }
+    return result;
+}
+
+void Sweep::fork(const Checkpoint* init_origin)
+{
+    origin = init_origin;
+}
+
+bool Sweep::run(const std::vector<Person>& persons, size_t jobs, std::ostream& errors)
+{
+    _results = std::vector<Result>(size());
+    if (jobs == 0) { jobs = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+    jobs = std::min(jobs, _results.size());
+
+    // Потоки разбирают прогоны по одному; каждый результат записывается в свою ячейку.
+    std::atomic<size_t> next_run{0};
+    std::vector<std::thread> threads;
+    for (size_t job = 0; job < jobs; ++job)
+    {
+        threads.emplace_back([this, &persons, &next_run]()
+        {
+            for (size_t run = next_run++; run < _results.size(); run = next_run++)
+            { _results[run] = execute(persons, parameters(run)); }
+        });
+    }
+    for (size_t job = 0; job < threads.size(); ++job) { threads[job].join(); }
+
+    for (size_t run = 0; run < _results.size(); ++run)
+    {
+        if (!_results[run].is_restored)
+        {
+            errors << "Контрольная точка не соответствует параметрам модели (число этажей и лифтов должно совпадать)." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+void Sweep::print(std::ostream& output) const
+{
+    for (size_t parameter = 0; parameter < names.size(); ++parameter) { output << names[parameter] << "\t"; }
+    output << "ticks\tdelivered\twait_mean\twait_p90\twait_p99\twait_max\tride_mean\tride_p90\tthroughput\tbusy\twall_seconds" << std::endl;
+
+    for (size_t run = 0; run < _results.size(); ++run)
+    {
+        Result result = _results[run];
+        for (size_t parameter = 0; parameter < names.size(); ++parameter) { output << field(result.parameters, parameter) << "\t"; }
+        output << result.ticks << "\t"
+               << result.delivered << "\t"
+               << result.wait_mean << "\t"
+               << result.wait_p90 << "\t"
+               << result.wait_p99 << "\t"
+               << result.wait_max << "\t"
+               << result.ride_mean << "\t"
+               << result.ride_p90 << "\t"
+               << result.throughput_mean << "\t"
+               << result.busy << "\t"
+               << result.wall_seconds << std::endl;
+    }
+}
+
+// PROTECTED:
+Sweep::Parameters Sweep::parameters(size_t run) const
+{
+    // Номер прогона раскладывается по основаниям - числам значений параметров (последний параметр меняется быстрее всех).
+    Parameters result = base;
+    for (size_t parameter = values.size(); parameter-- > 0;)
+    {
+        if (values[parameter].empty()) { continue; }
+        field(result, parameter) = values[parameter][run % values[parameter].size()];
+        run /= values[parameter].size();
+    }
+    return result;
+}
+Sweep::Result Sweep::execute(const std::vector<Person>& persons, const Parameters& run_parameters) const
+{
+    Controller controller(floors_number, run_parameters.elevators_number, run_parameters.settings, options);
+    Result result;
+    result.parameters = run_parameters;
+    if (origin && !controller.restore(*origin))
+    {
+        result.is_restored = false;
+        return result;
+    }
+
+    ReplayArrivals arrivals(persons);
+    controller.run(arrivals);
+
+    const Metrics& metrics = controller.get_metrics();
+    result.ticks = controller.get_timestamp();
+    result.delivered = controller.get_delivered();
+    result.wait_mean = metrics.waits().mean();
+    result.wait_p90 = metrics.waits().percentile(90);
+    result.wait_p99 = metrics.waits().percentile(99);
+    result.wait_max = metrics.waits().max();
+    result.ride_mean = metrics.rides().mean();
+    result.ride_p90 = metrics.rides().percentile(90);
+    result.throughput_mean = metrics.throughput().mean();
+    result.busy = 1.0 - metrics.fleet_share(Elevator::State::Waiting, result.ticks);
+    result.wall_seconds = controller.get_wall_seconds();
+    return result;
+}
+uint64_t& Sweep::field(Parameters& parameters, size_t parameter)
+{
+    switch (parameter)
+    {
+        case 0: { return parameters.elevators_number; }
+        case 1: { return parameters.settings.capacity; }
+        case 2: { return parameters.settings.stage; }
+        case 3: { return parameters.settings.open; }
+        case 4: { return parameters.settings.idle; }
+        case 5: { return parameters.settings.close; }
+        case 6: { return parameters.settings.in; }
+        default: { return parameters.settings.out; }
+    }
+}
+
+// PRIVATE:
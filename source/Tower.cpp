@@ -0,0 +1,225 @@
+#include "Tower.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+////////////////     Tower     /////////////////
+// Многозонная модель здания.
+// PUBLIC:
+bool Tower::parse(const std::string& specification, size_t floors_number, std::vector<Zone>& zones, std::ostream& errors)
+{
+    zones.clear();
+    const char* begin = specification.c_str();
+    char* end = nullptr;
+    bool is_valid = true;
+    while (is_valid)
+    {
+        Zone zone = {0, 0, 0};
+        zone.lowest = std::strtol(begin, &end, 10);
+        is_valid = (end != begin) && (*end == '-');
+        begin = end + 1;
+        zone.highest = is_valid ? std::strtol(begin, &end, 10) : 0;
+        is_valid = is_valid && (end != begin) && (*end == ':');
+        begin = end + 1;
+        zone.elevators_number = is_valid ? std::strtoull(begin, &end, 10) : 0;
+        is_valid = is_valid && (end != begin) && ((*end == ',') || (*end == '\0'));
+
+        // Зоны идут подряд снизу вверх и имеют общие этажи пересадки.
+        is_valid = is_valid && (zone.lowest < zone.highest) && (zone.elevators_number > 0) &&
+                   (zone.lowest == (zones.empty() ? 0 : zones.back().highest));
+        if (is_valid) { zones.push_back(zone); }
+        if (!is_valid || (*end == '\0')) { break; }
+        begin = end + 1;
+    }
+
+    if (!is_valid || zones.empty() || (static_cast<size_t>(zones.back().highest) + 1 != floors_number))
+    {
+        errors << "Некорректное разбиение на зоны: " << specification << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Tower::Tower(const std::vector<Zone>& init_zones, const Elevator::Settings& settings, const Controller::Options& options, tick_t init_epoch) :
+    zones(init_zones), barrier(init_zones.size() + 1)
+{
+    epoch = init_epoch ? init_epoch : 1;
+
+    // Контроллер каждой зоны работает в собственных номерах этажей (от нижнего этажа зоны);
+    // вышедшие не на конечном этаже люди попадают в исходящую очередь пересадок.
+    for (size_t zone = 0; zone < zones.size(); ++zone)
+    {
+        shards.emplace_back(new Shard());
+        Shard& shard = *shards.back();
+        shard.zone = zones[zone];
+
+        Controller::Options zone_options = options;
+        zone_options.interactive = false;
+        zone_options.report_interval = 0;
+        zone_options.alighted = [&shard](const Person& person)
+        {
+            ssize_t floor = person.destination + shard.zone.lowest;
+            if ((person.final_destination < 0) || (person.final_destination == floor)) { return; }
+            shard.handoffs.push_back({person.alighted, floor, person.final_destination});
+        };
+        shard.controller.reset(new Controller(shard.zone.highest - shard.zone.lowest + 1, shard.zone.elevators_number, settings, zone_options));
+    }
+
+    for (size_t zone = 0; zone < zones.size(); ++zone)
+    { threads.emplace_back(&Tower::work, this, zone); }
+}
+Tower::~Tower()
+{
+    stop();
+}
+
+void Tower::run(Arrivals& arrivals)
+{
+    TRACE_SCOPE("Tower::run");
+    auto begin = std::chrono::steady_clock::now();
+
+    Person next_person = {0, 0, 0};
+    bool has_next = arrivals.next(next_person);
+    while (true)
+    {
+        // Пересадки предыдущей эпохи поступают в следующие зоны.
+        bool is_idle = true;
+        for (size_t zone = 0; zone < shards.size(); ++zone)
+        {
+            Shard& shard = *shards[zone];
+            for (size_t person = 0; person < shard.handoffs.size(); ++person)
+            {
+                Person transfer = shard.handoffs[person];
+                size_t target = route(transfer);
+                shards[target]->pending.push_back(transfer);
+                ++shards[target]->transfers;
+                ++transfers_count;
+                is_idle = false;
+            }
+            shard.handoffs.clear();
+            is_idle = is_idle && shard.controller->is_finished();
+        }
+
+        // Если все зоны простаивают, время переносится сразу к эпохе следующего прибытия.
+        if (is_idle && !has_next) { break; }
+        tick_t epoch_begin = epoch_end;
+        if (is_idle) { epoch_begin = std::max(epoch_begin, next_person.timestamp / epoch * epoch); }
+        epoch_end = epoch_begin + epoch;
+
+        // Прибытия текущей эпохи распределяются по зонам первых участков поездок.
+        while (has_next && (next_person.timestamp < epoch_end))
+        {
+            ++arrived_count;
+            size_t target = route(next_person);
+            if (target == rejected) { ++rejected_count; }
+            else { shards[target]->pending.push_back(next_person); }
+            has_next = arrivals.next(next_person);
+        }
+        is_draining = !has_next;
+
+        // Эпоха: зоны работают независимо до её конца.
+        ++epochs_count;
+        barrier.wait();
+        barrier.wait();
+    }
+
+    wall_time = std::chrono::steady_clock::now() - begin;
+}
+void Tower::print_summary(std::ostream& output)
+{
+    double seconds = std::chrono::duration<double>(wall_time).count();
+    tick_t ticks = 0;
+    size_t elevators_number = 0;
+    uint64_t delivered_count = 0;
+    for (size_t zone = 0; zone < shards.size(); ++zone)
+    {
+        ticks = std::max(ticks, shards[zone]->controller->get_timestamp());
+        elevators_number += shards[zone]->zone.elevators_number;
+        delivered_count += shards[zone]->controller->get_delivered();
+    }
+
+    output << "{"
+           << "\"floors\": " << zones.back().highest + 1 << ", "
+           << "\"elevators\": " << elevators_number << ", "
+           << "\"ticks\": " << ticks << ", "
+           << "\"epoch\": " << epoch << ", "
+           << "\"epochs\": " << epochs_count << ", "
+           << "\"arrived\": " << arrived_count << ", "
+           << "\"rejected\": " << rejected_count << ", "
+           << "\"delivered\": " << delivered_count - transfers_count << ", "
+           << "\"transfers\": " << transfers_count << ", "
+           << "\"wall_seconds\": " << seconds << ", "
+           << "\"ticks_per_second\": " << (seconds > 0.0 ? ticks / seconds : 0.0) << ", "
+           << "\"zones\": [";
+    for (size_t zone = 0; zone < shards.size(); ++zone)
+    {
+        const Shard& shard = *shards[zone];
+        output << (zone ? ", " : "") << "{"
+               << "\"lowest\": " << shard.zone.lowest << ", "
+               << "\"highest\": " << shard.zone.highest << ", "
+               << "\"elevators\": " << shard.zone.elevators_number << ", "
+               << "\"ticks\": " << shard.controller->get_timestamp() << ", "
+               << "\"delivered\": " << shard.controller->get_delivered() << ", "
+               << "\"transfers\": " << shard.transfers << ", "
+               << "\"metrics\": ";
+        shard.controller->get_metrics().print(output, shard.controller->get_timestamp());
+        output << "}";
+    }
+    output << "]}" << std::endl;
+}
+
+// PROTECTED:
+size_t Tower::route(Person& person) const
+{
+    // Конечный этаж поездки (для пересаживающихся - сохранённый при предыдущем участке).
+    ssize_t destination = (person.final_destination >= 0) ? person.final_destination : person.destination;
+    ssize_t top = zones.back().highest;
+    if ((person.origin < 0) || (person.origin > top) || (destination < 0) || (destination > top) || (person.origin == destination))
+    { return rejected; }
+
+    // Зона, из которой можно уехать в нужную сторону (этаж пересадки при движении вверх относится к верхней зоне, вниз - к нижней).
+    bool is_upwards = destination > person.origin;
+    size_t zone = 0;
+    while (is_upwards ? (person.origin >= zones[zone].highest) : (person.origin > zones[zone].highest)) { ++zone; }
+
+    // Участок поездки заканчивается на конечном этаже или на границе зоны.
+    person.destination = std::min(std::max(destination, zones[zone].lowest), zones[zone].highest);
+    person.final_destination = (person.destination == destination) ? -1 : destination;
+    return zone;
+}
+void Tower::work(size_t zone)
+{
+    Shard& shard = *shards[zone];
+    Controller& controller = *shard.controller;
+    while (true)
+    {
+        barrier.wait();
+        if (!is_running) { return; }
+
+        // Поступившие люди ставятся в очереди в моменты своего прибытия (в номерах этажей зоны).
+        for (size_t person = 0; person < shard.pending.size(); ++person)
+        {
+            Person local = shard.pending[person];
+            local.origin -= shard.zone.lowest;
+            local.destination -= shard.zone.lowest;
+            controller.advance(local.timestamp);
+            controller.enqueue(local);
+        }
+        shard.pending.clear();
+
+        // Когда прибытий больше нет, зона досчитывается только до развозки своих людей (пересадки могут продолжить её позже).
+        if (is_draining) { controller.settle(epoch_end); }
+        else { controller.advance(epoch_end); }
+
+        barrier.wait();
+    }
+}
+void Tower::stop()
+{
+    if (!is_running) { return; }
+    is_running = false;
+    barrier.wait();
+    for (size_t zone = 0; zone < threads.size(); ++zone) { threads[zone].join(); }
+}
+
+// PRIVATE:
@@ -0,0 +1,75 @@
+#include "Trace.hpp"
+
+#ifdef TRACE
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+// Общий список буферов всех потоков.
+static std::mutex trace_mutex;
+static std::vector<std::unique_ptr<Trace::Buffer>> trace_buffers;
+static const std::chrono::steady_clock::time_point trace_start = std::chrono::steady_clock::now();
+
+////////////////     Trace     /////////////////
+// Запись интервалов выполнения по потокам.
+// PUBLIC:
+uint64_t Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_start).count();
+}
+void Trace::record(const char* name, uint64_t begin, uint64_t end)
+{
+    Buffer& current = buffer();
+    if (current.events.size() >= buffer_limit)
+    {
+        ++current.dropped;
+        return;
+    }
+    current.events.push_back({name, begin, end});
+}
+void Trace::dump(std::ostream& output)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    output << "{\"traceEvents\": [";
+    bool is_first = true;
+    for (size_t index = 0; index < trace_buffers.size(); ++index)
+    {
+        const Buffer& current = *trace_buffers[index];
+        for (size_t event = 0; event < current.events.size(); ++event)
+        {
+            const Event& record = current.events[event];
+            output << (is_first ? "" : ",") << std::endl
+                   << "{\"name\": \"" << record.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << current.thread
+                   << ", \"ts\": " << record.begin / 1000.0 << ", \"dur\": " << (record.end - record.begin) / 1000.0 << "}";
+            is_first = false;
+        }
+        if (current.dropped)
+        {
+            output << (is_first ? "" : ",") << std::endl
+                   << "{\"name\": \"dropped\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 0, \"tid\": " << current.thread
+                   << ", \"ts\": 0, \"args\": {\"events\": " << current.dropped << "}}";
+            is_first = false;
+        }
+    }
+    output << std::endl << "]}" << std::endl;
+}
+
+// PROTECTED:
+Trace::Buffer& Trace::buffer()
+{
+    thread_local Buffer* current = nullptr;
+    if (!current)
+    {
+        std::lock_guard<std::mutex> lock(trace_mutex);
+        trace_buffers.emplace_back(new Buffer());
+        current = trace_buffers.back().get();
+        current->thread = trace_buffers.size() - 1;
+        current->events.reserve(4096);
+    }
+    return *current;
+}
+
+// PRIVATE:
+
+#endif
@@ -0,0 +1,116 @@
+#include "TrafficGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//////////////// TrafficGenerator /////////////////
+// Синтетический поток прибытий.
+// PUBLIC:
+bool TrafficGenerator::preset(const std::string& name, size_t floors_number, double rate, tick_t duration, Profile& profile)
+{
+    profile = Profile();
+
+    // Веса этажей: для межэтажного потока - все этажи, иначе - все, кроме вестибюля.
+    std::vector<double> all_floors(floors_number, 1.0);
+    std::vector<double> upper_floors(floors_number, 1.0);
+    if (floors_number > 1) { upper_floors[0] = 0.0; }
+
+    if (name == "uniform")
+    {
+        profile.rates = { {0, rate}, {duration, rate} };
+        profile.origins = all_floors;
+        profile.destinations = all_floors;
+    }
+    else if (name == "up-peak")
+    {
+        profile.rates = { {0, 0.2 * rate}, {duration / 2, rate}, {duration, 0.2 * rate} };
+        profile.origins = upper_floors;
+        profile.destinations = upper_floors;
+        profile.lobby_origin = 0.85;
+        profile.lobby_destination = 0.5;
+    }
+    else if (name == "down-peak")
+    {
+        profile.rates = { {0, 0.2 * rate}, {duration / 2, rate}, {duration, 0.2 * rate} };
+        profile.origins = upper_floors;
+        profile.destinations = upper_floors;
+        profile.lobby_origin = 0.05;
+        profile.lobby_destination = 0.85;
+    }
+    else if (name == "lunch")
+    {
+        profile.rates = { {0, 0.3 * rate}, {duration / 4, rate}, {duration / 2, 0.5 * rate}, {3 * duration / 4, rate}, {duration, 0.3 * rate} };
+        profile.origins = upper_floors;
+        profile.destinations = upper_floors;
+        profile.lobby_origin = 0.4;
+        profile.lobby_destination = 0.45;
+    }
+    else { return false; }
+    return true;
+}
+
+TrafficGenerator::TrafficGenerator(const Profile& init_profile, tick_t init_duration, uint64_t seed, uint64_t init_limit) : generator(seed)
+{
+    profile = init_profile;
+    duration = init_duration;
+    limit = init_limit;
+
+    for (size_t point = 0; point < profile.rates.size(); ++point)
+    { rate_max = std::max(rate_max, profile.rates[point].second); }
+    origins = std::discrete_distribution<size_t>(profile.origins.begin(), profile.origins.end());
+    destinations = std::discrete_distribution<size_t>(profile.destinations.begin(), profile.destinations.end());
+}
+
+bool TrafficGenerator::next(Person& person)
+{
+    if ((rate_max <= 0.0) || (floors() == 0)) { return false; }
+    if (limit && (generated >= limit)) { return false; }
+
+    // Прореживание: кандидаты порождаются с наибольшей интенсивностью и принимаются с вероятностью rate(t) / rate_max.
+    do
+    {
+        time += -std::log(1.0 - uniform(generator)) / rate_max;
+        if (time >= static_cast<double>(duration)) { return false; }
+    }
+    while (uniform(generator) * rate_max > rate(time));
+
+    person = {static_cast<tick_t>(time), 0, 0};
+    person.origin = (uniform(generator) < profile.lobby_origin) ? 0 : static_cast<ssize_t>(origins(generator));
+
+    // Этаж назначения отличается от этажа прибытия (кроме здания из одного этажа).
+    if ((person.origin != 0) && (uniform(generator) < profile.lobby_destination)) { person.destination = 0; }
+    else
+    {
+        person.destination = person.origin;
+        for (size_t attempt = 0; (attempt < 64) && (person.destination == person.origin); ++attempt)
+        { person.destination = static_cast<ssize_t>(destinations(generator)); }
+    }
+
+    ++generated;
+    return true;
+}
+
+// PROTECTED:
+double TrafficGenerator::rate(double at) const
+{
+    const std::vector<std::pair<tick_t, double>>& rates = profile.rates;
+    if (rates.empty()) { return 0.0; }
+    if (at <= static_cast<double>(rates.front().first)) { return rates.front().second; }
+    for (size_t point = 1; point < rates.size(); ++point)
+    {
+        double begin = static_cast<double>(rates[point - 1].first);
+        double end = static_cast<double>(rates[point].first);
+        if (at <= end)
+        {
+            double share = (end > begin) ? (at - begin) / (end - begin) : 1.0;
+            return rates[point - 1].second + share * (rates[point].second - rates[point - 1].second);
+        }
+    }
+    return rates.back().second;
+}
+size_t TrafficGenerator::floors() const
+{
+    return std::max(profile.origins.size(), profile.destinations.size());
+}
+
+// PRIVATE: